@@ -23,6 +23,9 @@ namespace UnTech::ArgParser_Impl {
 template <class Config>
 [[nodiscard]] static inline const typename Config::OutputT parseProgramArguments(const Config& config, int argc, const char** argv);
 
+template <class Config>
+[[nodiscard]] static inline auto parseProgramArguments(const Config& config, const std::string_view execName, std::span<const char*> arguments) -> const typename Config::OutputT;
+
 template <typename T>
 [[nodiscard]] static inline auto parseArg(const std::string_view value, const std::string_view argLongName) -> T;
 }
@@ -150,6 +153,21 @@ template <class Config>
     return ArgParser_Impl::parseProgramArguments(config, argc, argv);
 }
 
+// Parses the arguments that follow a sub-command switch (ie, `untech-png2snes --batch ...`).
+// `execName` is used in the help text.
+template <class Config>
+[[nodiscard]] static inline auto parseSubcommandArguments(const Config& config, const std::string_view execName, std::span<const char*> arguments) -> const typename Config::OutputT
+{
+    const bool valid = std::all_of(arguments.begin(), arguments.end(),
+                                   [](const char* a) { return a && *a != 0; });
+    if (not valid) {
+        std::cerr << "Invalid program arguments\n";
+        exit(EXIT_FAILURE);
+    }
+
+    return ArgParser_Impl::parseProgramArguments(config, execName, arguments);
+}
+
 }
 
 namespace UnTech::ArgParser_Impl {
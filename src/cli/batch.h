@@ -0,0 +1,189 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "models/common/exceptions.h"
+#include "models/common/file.h"
+#include "models/common/iterators.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace UnTech::Batch {
+
+struct ManifestLine {
+    unsigned lineNumber;
+    std::vector<std::filesystem::path> files;
+};
+
+static inline bool isManifestWhitespace(const char8_t c)
+{
+    return c == u8' ' || c == u8'\t' || c == u8'\r';
+}
+
+// Reads a batch manifest file.
+//
+// A manifest contains one job per line.
+// Each job is a whitespace separated list of filenames (filenames containing
+// spaces can be surrounded by double quotes).
+// Relative filenames are relative to the directory containing the manifest.
+// Blank lines and lines starting with `#` are ignored.
+//
+// Throws an exception if a line does not contain `minFiles` to `maxFiles` filenames.
+[[nodiscard]] static inline std::vector<ManifestLine> readManifest(const std::filesystem::path& filename,
+                                                                   const unsigned minFiles, const unsigned maxFiles)
+{
+    const std::u8string text = File::readUtf8TextFile(filename);
+    const std::filesystem::path directory = std::filesystem::absolute(filename).parent_path();
+
+    std::vector<ManifestLine> out;
+
+    unsigned lineNumber = 0;
+    auto it = text.begin();
+
+    while (it != text.end()) {
+        lineNumber++;
+
+        const auto lineEnd = std::find(it, text.end(), u8'\n');
+
+        ManifestLine line{ lineNumber, {} };
+
+        while (it != lineEnd) {
+            if (isManifestWhitespace(*it)) {
+                it++;
+                continue;
+            }
+            if (*it == u8'#' && line.files.empty()) {
+                it = lineEnd;
+                break;
+            }
+
+            std::u8string token;
+
+            if (*it == u8'"') {
+                const auto tokenEnd = std::find(it + 1, lineEnd, u8'"');
+                if (tokenEnd == lineEnd) {
+                    throw runtime_error(filename.u8string(), u8":", lineNumber, u8": missing closing quote");
+                }
+                token.assign(it + 1, tokenEnd);
+                it = tokenEnd + 1;
+            }
+            else {
+                const auto tokenEnd = std::find_if(it, lineEnd, isManifestWhitespace);
+                token.assign(it, tokenEnd);
+                it = tokenEnd;
+            }
+
+            line.files.push_back(directory / std::filesystem::path(token));
+        }
+
+        if (it != text.end()) {
+            // skip new line
+            it++;
+        }
+
+        if (line.files.empty()) {
+            continue;
+        }
+
+        if (line.files.size() < minFiles || line.files.size() > maxFiles) {
+            if (minFiles == maxFiles) {
+                throw runtime_error(filename.u8string(), u8":", lineNumber, u8": expected ", minFiles, u8" filenames");
+            }
+            else {
+                throw runtime_error(filename.u8string(), u8":", lineNumber, u8": expected ", minFiles, u8" to ", maxFiles, u8" filenames");
+            }
+        }
+
+        out.push_back(std::move(line));
+    }
+
+    return out;
+}
+
+// Returns the number of worker threads to use.
+// If `nJobs` is 0, one thread is used per hardware thread.
+[[nodiscard]] static inline unsigned threadCount(unsigned nJobs, const size_t nItems)
+{
+    if (nJobs == 0) {
+        nJobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min<size_t>(nJobs, nItems));
+}
+
+// Calls `fn(i)` for every `i` in `0 .. nItems - 1` on `nThreads` threads.
+//
+// Returns the exception thrown by each `fn` call (or nullptr if the call succeeded).
+[[nodiscard]] static inline std::vector<std::exception_ptr> parallelFor(const unsigned nThreads, const size_t nItems,
+                                                                        const std::function<void(size_t)>& fn)
+{
+    std::vector<std::exception_ptr> errors(nItems);
+    std::atomic_size_t nextItem = 0;
+
+    auto worker = [&]() {
+        while (true) {
+            const size_t i = nextItem.fetch_add(1, std::memory_order_relaxed);
+            if (i >= nItems) {
+                break;
+            }
+
+            try {
+                fn(i);
+            }
+            catch (...) {
+                errors.at(i) = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+
+    for (unsigned t = 1; t < nThreads; t++) {
+        threads.emplace_back(worker);
+    }
+
+    // The current thread is also a worker
+    worker();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return errors;
+}
+
+// Prints the errors returned by `parallelFor` to `std::cerr`.
+// Returns the number of errors.
+template <typename ItemNameFunction>
+static inline unsigned printErrors(const std::vector<std::exception_ptr>& errors, ItemNameFunction itemName)
+{
+    unsigned nErrors = 0;
+
+    for (const auto i : range(errors.size())) {
+        if (errors.at(i)) {
+            nErrors++;
+
+            try {
+                std::rethrow_exception(errors.at(i));
+            }
+            catch (const std::exception& ex) {
+                std::cerr << "ERROR: " << itemName(i) << ": " << ex.what() << '\n';
+            }
+        }
+    }
+
+    return nErrors;
+}
+
+}
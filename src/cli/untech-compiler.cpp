@@ -6,10 +6,15 @@
 
 #include "argparser.h"
 #include "models/common/file.h"
+#include "models/common/profiler.h"
+#include "models/common/string.h"
+#include "models/common/stringbuilder.h"
 #include "models/common/stringstream.h"
 #include "models/common/u8strings.h"
 #include "models/project/project-compiler.h"
 #include "models/project/project.h"
+#include "models/snes/cartridge.h"
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
 
@@ -22,6 +27,12 @@ struct Args {
 
     std::filesystem::path outputIncFilename;
     std::filesystem::path outputBinFilename;
+
+    std::filesystem::path traceFilename;
+    std::filesystem::path dmaReportFilename;
+    std::filesystem::path roomReportFilename;
+    std::filesystem::path patchRomFilename;
+    std::filesystem::path recordRomFilename;
 };
 
 // clang-format off
@@ -30,20 +41,151 @@ constexpr static auto ARG_PARSER_CONFIG = argParserConfig(
     "utproject file",
 
     RequiredArg< &Args::outputIncFilename   >{  '\0',   "output-inc",  "output inc file"   },
-    RequiredArg< &Args::outputBinFilename   >{  '\0',   "output-bin",  "output bin file"   }
+    RequiredArg< &Args::outputBinFilename   >{  '\0',   "output-bin",  "output bin file"   },
+    OptionalArg< &Args::traceFilename       >{  '\0',   "trace",       "write compiler timings to a Chrome trace json file" },
+    OptionalArg< &Args::dmaReportFilename   >{  '\0',   "dma-report",  "write the estimated DMA cost of each MetaSprite animation frame to a CSV file" },
+    OptionalArg< &Args::roomReportFilename  >{  '\0',   "room-report", "write the RAM and ROM usage of each room to a CSV file" },
+    OptionalArg< &Args::patchRomFilename    >{  '\0',   "patch-rom",   "write the resource data into an existing sfc file (if it was assembled with the same inc file)" },
+    OptionalArg< &Args::recordRomFilename   >{  '\0',   "record-rom",  "record that an sfc file was assembled with the current inc file and exit (run after assembling)" }
 );
 // clang-format on
 
+static void writeTraceFile(const Args& args)
+{
+    if (!args.traceFilename.empty()) {
+        File::writeFile(args.traceFilename, Profiler::chromeTraceJson(Profiler::takeSpans()));
+    }
+}
+
+// FNV-1a (stable between builds and platforms)
+static uint64_t fnv1aHash(const std::u8string_view s)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char8_t c : s) {
+        hash = (hash ^ uint8_t(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+static Snes::Cartridge::MemoryMap cartridgeMemoryMap(const MemoryMapSettings& memoryMap)
+{
+    return memoryMap.mode == MappingMode::HIROM ? Snes::Cartridge::MemoryMap::HIROM
+                                                : Snes::Cartridge::MemoryMap::LOROM;
+}
+
+// The resources can only be patched into a ROM if the ROM was assembled with
+// the same inc file.
+//
+// The layout file is written next to the ROM by `--record-rom` (after the ROM
+// is assembled) and `--patch-rom`.  It contains a hash of the inc file the ROM
+// was assembled with and the ROM's size and checksum words, so a ROM that was
+// reassembled or replaced without being recorded cannot be patched.
+//
+// Only the ROM header is read, the checksum words are verified by `patchRom()`.
+static std::filesystem::path romLayoutFilename(const std::filesystem::path& romFilename)
+{
+    auto fn = romFilename;
+    fn += ".utlayout";
+    return fn;
+}
+
+static void writeRomLayout(const std::filesystem::path& romFilename, const std::u8string_view incData,
+                           const Snes::Cartridge::RomChecksum& rom)
+{
+    File::writeFile(romLayoutFilename(romFilename),
+                    stringBuilder(u8"inc ", fnv1aHash(incData), u8"\n",
+                                  u8"size ", rom.romSize, u8"\n",
+                                  u8"checksum ", uint32_t(rom.checksum), u8"\n",
+                                  u8"complement ", uint32_t(rom.complement), u8"\n"));
+}
+
+// Returns the recorded ROM checksum if the ROM was assembled with `incData`.
+static std::optional<Snes::Cartridge::RomChecksum> readRomLayout(const std::filesystem::path& romFilename,
+                                                                 const std::u8string_view incData)
+{
+    const auto layoutFilename = romLayoutFilename(romFilename);
+
+    if (!std::filesystem::exists(layoutFilename)) {
+        return std::nullopt;
+    }
+
+    const std::u8string layout = File::readUtf8TextFile(layoutFilename);
+    std::u8string_view text = layout;
+
+    auto readLine = [&](const std::u8string_view key) -> std::u8string_view {
+        const auto eol = text.find(u8'\n');
+        const auto line = text.substr(0, eol);
+        text.remove_prefix(eol != text.npos ? eol + 1 : text.size());
+
+        if (line.size() <= key.size() || !line.starts_with(key) || line.at(key.size()) != u8' ') {
+            return {};
+        }
+        return line.substr(key.size() + 1);
+    };
+
+    const auto incHash = readLine(u8"inc");
+    const auto romSize = String::toUint32(readLine(u8"size"));
+    const auto checksum = String::toUint16(readLine(u8"checksum"));
+    const auto complement = String::toUint16(readLine(u8"complement"));
+
+    if (incHash != stringBuilder(fnv1aHash(incData)) || !romSize || !checksum || !complement) {
+        return std::nullopt;
+    }
+
+    return Snes::Cartridge::RomChecksum{
+        .romSize = *romSize,
+        .checksum = *checksum,
+        .complement = *complement,
+    };
+}
+
+static Snes::Cartridge::PatchRomResult patchRom(const std::filesystem::path& romFilename, const MemoryMapSettings& memoryMap,
+                                                const Snes::Cartridge::RomChecksum& expected, const ProjectOutput& output)
+{
+    std::vector<Snes::Cartridge::RomPatch> patches;
+    patches.reserve(output.binaryBanks.size());
+
+    size_t binOffset = 0;
+    for (const auto& bank : output.binaryBanks) {
+        const std::span<const uint8_t> data(output.binaryData.data() + binOffset, bank.size);
+        patches.push_back({ memoryMap.bankFileOffset(bank.bankId), data });
+        binOffset += bank.size;
+    }
+    assert(binOffset == output.binaryData.size());
+
+    return Snes::Cartridge::patchRom(romFilename, cartridgeMemoryMap(memoryMap), expected, patches);
+}
+
 int compile(const Args& args)
 {
+    if (!args.recordRomFilename.empty()) {
+        const std::unique_ptr<ProjectFile> project = loadProjectFile(args.inputFilename);
+        const auto rom = Snes::Cartridge::readRomChecksum(args.recordRomFilename, cartridgeMemoryMap(project->projectSettings.memoryMap));
+
+        // The ROM was assembled with the inc file on disk, not the output of this project.
+        writeRomLayout(args.recordRomFilename, File::readUtf8TextFile(args.outputIncFilename), rom);
+        return EXIT_SUCCESS;
+    }
+
     const std::filesystem::path& relativeBinaryFilePath = args.outputBinFilename.lexically_relative(args.outputIncFilename.parent_path());
 
+    if (!args.traceFilename.empty()) {
+        Profiler::setEnabled(true);
+    }
+
     std::unique_ptr<ProjectFile> project = loadProjectFile(args.inputFilename);
     project->loadAllFiles();
 
     StringStream errorStream;
 
-    std::unique_ptr<ProjectOutput> output = compileProject(*project, relativeBinaryFilePath, errorStream);
+    const ProjectCompilerOptions options{
+        .metaSpriteDmaReport = !args.dmaReportFilename.empty(),
+        .roomSizeReport = !args.roomReportFilename.empty(),
+    };
+
+    std::unique_ptr<ProjectOutput> output = compileProject(*project, relativeBinaryFilePath, errorStream, options);
+
+    writeTraceFile(args);
 
     // Print errors
     if (errorStream.size() != 0) {
@@ -55,9 +197,32 @@ int compile(const Args& args)
         return EXIT_FAILURE;
     }
 
+    if (!args.patchRomFilename.empty()) {
+        // The ROM is patched before the output files are written.
+        // The inc and bin files on disk must match the ROM if it cannot be patched.
+        const auto expected = readRomLayout(args.patchRomFilename, output->incData);
+        if (!expected) {
+            std::cerr << "Unable to patch " << args.patchRomFilename << ": the ROM was not assembled with the current inc file.\n"
+                      << "Compile without --patch-rom, reassemble the ROM and record it with --record-rom.\n";
+            return EXIT_FAILURE;
+        }
+
+        const auto patched = patchRom(args.patchRomFilename, project->projectSettings.memoryMap, *expected, *output);
+        writeRomLayout(args.patchRomFilename, output->incData, patched.checksum);
+
+        std::cout << "Patched " << patched.nChanged << " resource banks in " << args.patchRomFilename << '\n';
+    }
+
     File::writeFile(args.outputIncFilename, output->incData);
     File::writeFile(args.outputBinFilename, output->binaryData);
 
+    if (!args.dmaReportFilename.empty()) {
+        File::writeFile(args.dmaReportFilename, output->metaSpriteDmaReport);
+    }
+    if (!args.roomReportFilename.empty()) {
+        File::writeFile(args.roomReportFilename, output->roomSizeReport);
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -5,14 +5,18 @@
  */
 
 #include "argparser.h"
+#include "batch.h"
 #include "models/common/exceptions.h"
 #include "models/common/file.h"
 #include "models/common/indexedimage.h"
 #include "models/snes/bit-depth.h"
 #include "models/snes/image2snes.h"
 #include "models/snes/tile-data.h"
+#include "models/snes/tilesetinserter.h"
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 
 using namespace UnTech;
 using namespace UnTech::Snes;
@@ -53,24 +57,78 @@ constexpr static auto ARG_PARSER_CONFIG = argParserConfig(
 );
 // clang-format on
 
-static int process(const Args& args)
-{
-    const auto bitDepth = toBitDepthSpecial(args.bpp);
+// Batch mode: `untech-png2snes --batch [options] <manifest file>`
+//
+// Each line of the manifest contains the files of a single image:
+//      <png file> <tileset file> <tilemap file> <palette file>
+//
+// If `--tileset` is used the tiles of every image are stored in a
+// single deduplicated tileset and each line of the manifest contains:
+//      <png file> <tilemap file> <palette file>
+struct BatchArgs {
+    std::filesystem::path inputFilename;
 
-    Image2Snes image2Snes(bitDepth);
+    unsigned bpp;
+    std::filesystem::path sharedTilesetFilename; // optional
+
+    unsigned tileOffset;
+    unsigned maxTiles;
+    unsigned paletteOffset;
+    unsigned maxPalettes;
+    unsigned tilemapOrder;
+
+    unsigned jobs;
+    bool verbose;
+};
+
+// clang-format off
+constexpr static auto BATCH_ARG_PARSER_CONFIG = argParserConfig(
+    "UnTech png2snes",
+    "manifest file",
+
+    RequiredArg<    &BatchArgs::bpp                     >{  'b',    "bpp",              "bits per pixel",                               },
+    OptionalArg<    &BatchArgs::sharedTilesetFilename   >{  't',    "tileset",          "shared tileset output file"                    },
+    OptionalArg<    &BatchArgs::tileOffset              >{  '\0',   "tile-offset",      "tile offset",                          0U      },
+    OptionalArg<    &BatchArgs::maxTiles                >{  '\0',   "max-tiles",        "maximum number of tiles",              1024U   },
+    OptionalArg<    &BatchArgs::paletteOffset           >{  '\0',   "palette-offset",   "palette offset",                       0U      },
+    OptionalArg<    &BatchArgs::maxPalettes             >{  '\0',   "max-palettes",     "maximum number of palettes",           8U      },
+    OptionalArg<    &BatchArgs::tilemapOrder            >{  '\0',   "order",            "tilemap order",                        0U      },
+    OptionalArg<    &BatchArgs::jobs                    >{  'j',    "jobs",             "number of threads (0 = all cores)",    0U      },
+    BooleanArg<     &BatchArgs::verbose                 >{  'v',    "verbose",          "verbose output"                                }
+);
+// clang-format on
+
+template <typename ArgsT>
+static void applySettings(Image2Snes& image2Snes, const ArgsT& args)
+{
     image2Snes.setTileOffset(args.tileOffset);
     image2Snes.setMaxTiles(args.maxTiles);
     image2Snes.setPaletteOffset(args.paletteOffset);
     image2Snes.setMaxPalettes(args.maxPalettes);
     image2Snes.setOrder(args.tilemapOrder);
+}
 
-    const auto image = IndexedImage::loadPngImage_shared(args.inputFilename);
+static std::shared_ptr<const IndexedImage> loadImage(const std::filesystem::path& filename)
+{
+    auto image = IndexedImage::loadPngImage_shared(filename);
     assert(image);
 
     if (image->empty()) {
         throw runtime_error(image->errorString());
     }
 
+    return image;
+}
+
+static int process(const Args& args)
+{
+    const auto bitDepth = toBitDepthSpecial(args.bpp);
+
+    Image2Snes image2Snes(bitDepth);
+    applySettings(image2Snes, args);
+
+    const auto image = loadImage(args.inputFilename);
+
     if (args.verbose) {
         std::cout << "SETTINGS:\n"
                   << "   Bit Depth:      " << args.bpp << "bpp\n"
@@ -111,9 +169,88 @@ static int process(const Args& args)
                   << '\n';
     }
 
-    File::writeFile(args.tilesetFilename, image2Snes.tilesetSnesData());
-    File::writeFile(args.tilemapFilename, image2Snes.tilemap().snesData());
-    File::writeFile(args.paletteFilename, image2Snes.paletteSnesData());
+    File::writeFileIfChanged(args.tilesetFilename, image2Snes.tilesetSnesData());
+    File::writeFileIfChanged(args.tilemapFilename, image2Snes.tilemap().snesData());
+    File::writeFileIfChanged(args.paletteFilename, image2Snes.paletteSnesData());
+
+    return EXIT_SUCCESS;
+}
+
+static int processBatch(const BatchArgs& args)
+{
+    const auto bitDepth = toBitDepthSpecial(args.bpp);
+    const bool sharedTileset = !args.sharedTilesetFilename.empty();
+
+    const unsigned nFiles = sharedTileset ? 3 : 4;
+    const auto manifest = Batch::readManifest(args.inputFilename, nFiles, nFiles);
+
+    std::vector<std::unique_ptr<Image2Snes>> converters(manifest.size());
+    std::atomic_uint nFilesWritten = 0;
+
+    auto writeFile = [&](const std::filesystem::path& filename, const std::vector<uint8_t>& data) {
+        if (File::writeFileIfChanged(filename, data)) {
+            nFilesWritten++;
+        }
+    };
+
+    // The images are converted in parallel.
+    const unsigned nThreads = Batch::threadCount(args.jobs, manifest.size());
+    const auto errors = Batch::parallelFor(nThreads, manifest.size(), [&](const size_t i) {
+        const auto& files = manifest.at(i).files;
+
+        auto image2Snes = std::make_unique<Image2Snes>(bitDepth);
+        applySettings(*image2Snes, args);
+
+        image2Snes->process(*loadImage(files.at(0)));
+
+        if (!sharedTileset) {
+            writeFile(files.at(1), image2Snes->tilesetSnesData());
+            writeFile(files.at(2), image2Snes->tilemap().snesData());
+            writeFile(files.at(3), image2Snes->paletteSnesData());
+        }
+
+        converters.at(i) = std::move(image2Snes);
+    });
+
+    const unsigned nErrors = Batch::printErrors(errors, [&](size_t i) { return manifest.at(i).files.at(0); });
+    if (nErrors > 0) {
+        std::cerr << nErrors << " of " << manifest.size() << " images failed\n";
+        return EXIT_FAILURE;
+    }
+
+    if (sharedTileset) {
+        // The shared tileset is built in manifest order so the tile ids do not
+        // depend on the order the threads finished in.
+        std::vector<Tile8px> tileset;
+        TilesetInserter8px tilesetInserter(tileset);
+
+        for (const auto i : range(manifest.size())) {
+            const auto& files = manifest.at(i).files;
+            auto& image2Snes = *converters.at(i);
+
+            try {
+                image2Snes.moveTilesToSharedTileset(tilesetInserter);
+            }
+            catch (const std::exception& ex) {
+                std::cerr << "ERROR: " << files.at(0) << ": " << ex.what() << '\n';
+                return EXIT_FAILURE;
+            }
+
+            writeFile(files.at(1), image2Snes.tilemap().snesData());
+            writeFile(files.at(2), image2Snes.paletteSnesData());
+        }
+
+        writeFile(args.sharedTilesetFilename, snesTileData(tileset, bitDepth));
+
+        if (args.verbose) {
+            std::cout << "Shared tileset: " << tileset.size() << " tiles\n";
+        }
+    }
+
+    if (args.verbose) {
+        std::cout << manifest.size() << " images converted using " << nThreads << " threads, "
+                  << nFilesWritten << " files written\n";
+    }
 
     return EXIT_SUCCESS;
 }
@@ -121,6 +258,12 @@ static int process(const Args& args)
 int main(int argc, const char* argv[])
 {
     try {
+        if (argc >= 2 && argv[1] == std::string_view("--batch")) {
+            const std::string execName = std::string(argv[0]) + " --batch";
+            const BatchArgs args = parseSubcommandArguments(BATCH_ARG_PARSER_CONFIG, execName, std::span(argv + 2, argc - 2));
+            return processBatch(args);
+        }
+
         const Args args = parseProgramArguments(ARG_PARSER_CONFIG, argc, argv);
         return process(args);
     }
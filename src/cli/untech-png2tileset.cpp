@@ -5,9 +5,12 @@
  */
 
 #include "argparser.h"
+#include "batch.h"
 #include "models/common/exceptions.h"
+#include "models/common/file.h"
 #include "models/common/indexedimage.h"
 #include "models/snes/image2tileset.h"
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 
@@ -34,18 +37,88 @@ constexpr static auto ARG_PARSER_CONFIG = argParserConfig(
 );
 // clang-format on
 
-int process(const Args& args)
+// Batch mode: `untech-png2tileset --batch [options] <manifest file>`
+//
+// Each line of the manifest contains the files of a single image:
+//      <png file> <tileset file> [palette file]
+struct BatchArgs {
+    std::filesystem::path inputFilename;
+
+    unsigned bpp;
+    unsigned jobs;
+    bool verbose;
+};
+
+// clang-format off
+constexpr static auto BATCH_ARG_PARSER_CONFIG = argParserConfig(
+    "UnTech png2tileset",
+    "manifest file",
+
+    RequiredArg< &BatchArgs::bpp        >{  'b',    "bpp",      "bits per pixel",                           },
+    OptionalArg< &BatchArgs::jobs       >{  'j',    "jobs",     "number of threads (0 = all cores)",    0U  },
+    BooleanArg<  &BatchArgs::verbose    >{  'v',    "verbose",  "verbose output"                            }
+);
+// clang-format on
+
+static bool convertImage(const std::filesystem::path& imageFilename, const BitDepthSpecial bitDepth,
+                         const std::filesystem::path& tilesetFilename, const std::filesystem::path& paletteFilename)
 {
-    const auto image = IndexedImage::loadPngImage_shared(args.inputFilename);
+    const auto image = IndexedImage::loadPngImage_shared(imageFilename);
     assert(image);
 
     if (image->empty()) {
         throw runtime_error(image->errorString());
     }
 
+    ImageToTileset converter(bitDepth);
+    converter.process(*image);
+
+    bool written = File::writeFileIfChanged(tilesetFilename, converter.tilesetSnesData());
+
+    if (!paletteFilename.empty()) {
+        written |= File::writeFileIfChanged(paletteFilename, converter.paletteSnesData());
+    }
+
+    return written;
+}
+
+int process(const Args& args)
+{
+    const auto bitDepth = toBitDepthSpecial(args.bpp);
+
+    convertImage(args.inputFilename, bitDepth, args.tilesetFilename, args.paletteFilename);
+
+    return EXIT_SUCCESS;
+}
+
+static int processBatch(const BatchArgs& args)
+{
     const auto bitDepth = toBitDepthSpecial(args.bpp);
+    const auto manifest = Batch::readManifest(args.inputFilename, 2, 3);
 
-    ImageToTileset::convertAndSave(*image, bitDepth, args.tilesetFilename, args.paletteFilename);
+    std::atomic_uint nChanged = 0;
+
+    const unsigned nThreads = Batch::threadCount(args.jobs, manifest.size());
+    const auto errors = Batch::parallelFor(nThreads, manifest.size(), [&](const size_t i) {
+        const auto& files = manifest.at(i).files;
+
+        const auto& paletteFilename = files.size() > 2 ? files.at(2) : std::filesystem::path();
+
+        if (convertImage(files.at(0), bitDepth, files.at(1), paletteFilename)) {
+            nChanged++;
+        }
+    });
+
+    const unsigned nErrors = Batch::printErrors(errors, [&](size_t i) { return manifest.at(i).files.at(0); });
+    if (nErrors > 0) {
+        std::cerr << nErrors << " of " << manifest.size() << " images failed\n";
+        return EXIT_FAILURE;
+    }
+
+    if (args.verbose) {
+        std::cout << manifest.size() << " images converted using " << nThreads << " threads, "
+                  << nChanged << " changed\n";
+    }
 
     return EXIT_SUCCESS;
 }
@@ -53,6 +126,12 @@ int process(const Args& args)
 int main(int argc, const char* argv[])
 {
     try {
+        if (argc >= 2 && argv[1] == std::string_view("--batch")) {
+            const std::string execName = std::string(argv[0]) + " --batch";
+            const BatchArgs args = parseSubcommandArguments(BATCH_ARG_PARSER_CONFIG, execName, std::span(argv + 2, argc - 2));
+            return processBatch(args);
+        }
+
         const Args args = parseProgramArguments(ARG_PARSER_CONFIG, argc, argv);
         return process(args);
     }
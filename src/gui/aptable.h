@@ -224,34 +224,41 @@ inline void apTable_data_custom(const std::shared_ptr<EditorT>& editor, const st
                             std::tuple_cat(std::forward_as_tuple(*data), listArgs));
 
     if (list) {
-        for (auto p : enumerate(*list)) {
-            const auto& index = p.first;
-            typename ActionPolicy::ListT::value_type& item = p.second;
+        // Only the visible rows are processed.
+        // NOTE: All rows in the list MUST have the same height.
+        ImGuiListClipper clipper;
+        clipper.Begin(list->size());
 
-            ImGui::TableNextRow();
+        while (clipper.Step()) {
+            for (const auto row : irange(clipper.DisplayStart, clipper.DisplayEnd)) {
+                const size_t index = row;
+                typename ActionPolicy::ListT::value_type& item = list->at(index);
 
-            ImGui::PushID(index);
+                ImGui::TableNextRow();
 
-            ImGui::TableNextColumn();
-            selFunction(&sel, index);
+                ImGui::PushID(index);
 
-            bool edited = false;
-
-            auto processColumn = [&](const auto& cf) {
                 ImGui::TableNextColumn();
-                ImGui::SetNextItemWidth(-1);
-                const auto itemEdited = cf(item);
+                selFunction(&sel, index);
 
-                static_assert(std::is_same_v<decltype(itemEdited), const bool>, "columnFunction must return a bool");
-                edited |= itemEdited;
-            };
-            (processColumn(columnFunctions), ...);
+                bool edited = false;
 
-            if (edited) {
-                AbstractListActions<ActionPolicy>::itemEdited(editor, listArgs, index);
-            }
+                auto processColumn = [&](const auto& cf) {
+                    ImGui::TableNextColumn();
+                    ImGui::SetNextItemWidth(-1);
+                    const auto itemEdited = cf(item);
+
+                    static_assert(std::is_same_v<decltype(itemEdited), const bool>, "columnFunction must return a bool");
+                    edited |= itemEdited;
+                };
+                (processColumn(columnFunctions), ...);
 
-            ImGui::PopID();
+                if (edited) {
+                    AbstractListActions<ActionPolicy>::itemEdited(editor, listArgs, index);
+                }
+
+                ImGui::PopID();
+            }
         }
     }
 }
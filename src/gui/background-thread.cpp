@@ -53,16 +53,21 @@ static void bgThread(
             queueChanged.acquire();
 
             projectFile.read([&](const auto& pf) {
+                std::optional<Project::PriorityResource> priority;
+
                 // Process the queue
                 queue.access([&](auto& queue) {
                     markResourcesUnchanged(queue, compilerStatus, pf);
                     cancelToken.clear();
+
+                    if (queue.priorityResource) {
+                        priority = Project::PriorityResource{ queue.priorityResource->type, queue.priorityResource->index };
+                    }
                 });
 
-                Project::compileResources(compilerStatus, projectData, pf, cancelToken);
+                Project::compileResources(compilerStatus, projectData, pf, priority, cancelToken);
 
-                const auto entityRomDataCompileId = compilerStatus.getCompileId(ProjectSettingsIndex::EntityRomData);
-                processEntityGraphics(pf, projectData, entityRomDataCompileId);
+                processEntityGraphics(pf, projectData, compilerStatus);
             });
         }
     }
@@ -100,6 +105,26 @@ void BackgroundThread::markResourceUnchecked(ItemIndex index)
     queueChanged.release();
 }
 
+void BackgroundThread::setPriorityResource(std::optional<ItemIndex> index)
+{
+    bool changed = false;
+
+    queue.access([&](auto& q) {
+        if (q.priorityResource != index) {
+            q.priorityResource = index;
+            changed = true;
+
+            // Restart the compile so the new priority resource is compiled next.
+            // Resources that have already been compiled are not recompiled.
+            cancelToken.test_and_set();
+        }
+    });
+
+    if (changed) {
+        queueChanged.release();
+    }
+}
+
 void BackgroundThread::markResourceListMovedOrResized()
 {
     queue.access([&](auto& q) {
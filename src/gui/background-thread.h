@@ -13,6 +13,7 @@
 #include "models/project/project.h"
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <thread>
 
 namespace UnTech::Project {
@@ -28,6 +29,9 @@ public:
     struct ChangesQueue {
         bool resourceListMovedOrResized;
         std::vector<ItemIndex> resources;
+
+        // The resource in the currently open editor, compiled before the other items in its list.
+        std::optional<ItemIndex> priorityResource;
     };
 
 private:
@@ -53,6 +57,8 @@ public:
     // Must be called when a resource list changes size or is reordered
     void markResourceListMovedOrResized();
 
+    void setPriorityResource(std::optional<ItemIndex> index);
+
     const auto& compilerStatus() const { return _compilerStatus; }
     const auto& projectData() const { return _projectData; }
 
@@ -0,0 +1,352 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "bench-scene.h"
+#include "imgui.h"
+#include "item-index.h"
+#include "untech-editor.h"
+#include "models/common/exceptions.h"
+#include "models/common/iterators.h"
+#include "models/common/u8strings.h"
+#include "models/project/compiler-status.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <iomanip>
+#include <numbers>
+
+namespace UnTech::Gui {
+
+// Frames processed before the benchmark starts (allows the editor to build its textures and caches)
+constexpr unsigned WARMUP_FRAMES = 30;
+
+constexpr unsigned DEFAULT_FRAMES = 600;
+
+// Number of frames in each phase of the input script
+constexpr unsigned PHASE_FRAMES = 60;
+
+constexpr auto COMPILER_TIMEOUT = std::chrono::seconds(120);
+
+struct EditorName {
+    std::string_view name;
+    ResourceType type;
+};
+
+static constexpr std::array<EditorName, 7> editorNames{ {
+    { "project-settings", ResourceType::ProjectSettings },
+    { "export-order", ResourceType::FrameSetExportOrders },
+    { "frameset", ResourceType::FrameSets },
+    { "palette", ResourceType::Palettes },
+    { "background-image", ResourceType::BackgroundImages },
+    { "metatile-tileset", ResourceType::MataTileTilesets },
+    { "room", ResourceType::Rooms },
+} };
+
+const char* BenchScene::usage()
+{
+    return " --bench-scene <editor> <resource> <filename> [frames]\n"
+           "\n"
+           "Headless GUI benchmark.\n"
+           "Opens <resource> in the <editor>, processes a scripted sequence of inputs and prints the frame times.\n"
+           "<editor> is one of: project-settings, export-order, frameset, palette, background-image, metatile-tileset or room.\n"
+           "\n"
+           "To run the benchmark without a display use a software OpenGL renderer (ie: `LIBGL_ALWAYS_SOFTWARE=1`).\n";
+}
+
+BenchScene::Settings BenchScene::parseArguments(std::span<const char*> arguments)
+{
+    // arguments: <program> --bench-scene <editor> <resource> <filename> [frames]
+    if (arguments.size() < 5 || arguments.size() > 6) {
+        throw invalid_argument(u8"--bench-scene: invalid number of arguments");
+    }
+
+    const std::string_view editor = arguments[2];
+
+    const auto it = std::find_if(editorNames.begin(), editorNames.end(),
+                                 [&](const auto& e) { return e.name == editor; });
+    if (it == editorNames.end()) {
+        throw invalid_argument(u8"--bench-scene: unknown editor ", convert_old_string(editor));
+    }
+
+    unsigned nFrames = DEFAULT_FRAMES;
+
+    if (arguments.size() > 5) {
+        const std::string_view s = arguments[5];
+        const auto r = std::from_chars(s.data(), s.data() + s.size(), nFrames);
+        if (r.ec != std::errc{} || r.ptr != s.data() + s.size() || nFrames == 0) {
+            throw invalid_argument(u8"--bench-scene: invalid frame count");
+        }
+    }
+
+    return {
+        .type = it->type,
+        .resourceName = convert_old_string(arguments[3]),
+        .projectFilename = arguments[4],
+        .nFrames = nFrames,
+    };
+}
+
+BenchScene::BenchScene(Settings settings)
+    : _settings(std::move(settings))
+    , _state(State::WaitingForCompiler)
+    , _frame(0)
+    , _compileStart(Clock::now())
+    , _frameStart()
+    , _guiTime()
+    , _stats()
+{
+    _stats.reserve(_settings.nFrames);
+}
+
+static bool allResourcesChecked(const Project::CompilerStatus& status)
+{
+    using RS = Project::ResourceState;
+
+    const auto snapshot = status.snapshot();
+
+    return std::all_of(snapshot->lists.begin(), snapshot->lists.end(),
+                       [](const auto& l) { return l->state != RS::AllUnchecked && l->state != RS::Unchecked; });
+}
+
+void BenchScene::startFrame(UnTechEditor& editor)
+{
+    if (_state == State::WaitingForCompiler) {
+        const auto& status = editor.compilerStatus();
+
+        if (allResourcesChecked(status)) {
+            const auto snapshot = status.snapshot();
+            const auto& resources = snapshot->at(_settings.type).resources;
+
+            const auto it = std::find_if(resources.begin(), resources.end(),
+                                         [&](const auto& rs) { return rs->name == _settings.resourceName; });
+            if (it == resources.end()) {
+                throw runtime_error(u8"Cannot find resource: ", _settings.resourceName);
+            }
+
+            editor.openEditor(ItemIndex(_settings.type, unsigned(std::distance(resources.begin(), it))));
+
+            _state = State::WarmUp;
+            _frame = 0;
+        }
+        else if (Clock::now() - _compileStart > COMPILER_TIMEOUT) {
+            throw runtime_error(u8"Timeout waiting for the project to compile");
+        }
+    }
+
+    if (_state == State::Running) {
+        queueInputEvents(_frame);
+    }
+
+    _frameStart = Clock::now();
+}
+
+void BenchScene::guiProcessed()
+{
+    _guiTime = Clock::now() - _frameStart;
+}
+
+void BenchScene::endFrame()
+{
+    const auto frameTime = Clock::now() - _frameStart;
+
+    switch (_state) {
+    case State::WaitingForCompiler:
+    case State::Finished:
+        break;
+
+    case State::WarmUp:
+        _frame++;
+        if (_frame >= WARMUP_FRAMES) {
+            _state = State::Running;
+            _frame = 0;
+        }
+        break;
+
+    case State::Running: {
+        FrameStats stats{
+            .guiTime = _guiTime,
+            .frameTime = frameTime,
+            .drawCalls = 0,
+            .vertices = 0,
+            .indices = 0,
+        };
+
+        if (const ImDrawData* drawData = ImGui::GetDrawData()) {
+            for (const auto i : irange(drawData->CmdListsCount)) {
+                stats.drawCalls += drawData->CmdLists[i]->CmdBuffer.Size;
+            }
+            stats.vertices = drawData->TotalVtxCount;
+            stats.indices = drawData->TotalIdxCount;
+        }
+
+        _stats.push_back(stats);
+
+        _frame++;
+        if (_frame >= _settings.nFrames) {
+            _state = State::Finished;
+        }
+        break;
+    }
+    }
+}
+
+// The input script cycles through the following phases.
+// Coordinates are relative to the display, the editor's canvas is assumed to
+// be to the right of the project list sidebar.
+enum class InputPhase : unsigned {
+    Hover,
+    Scroll,
+    Zoom,
+    Paint,
+    Select,
+};
+constexpr unsigned N_INPUT_PHASES = 5;
+
+void BenchScene::queueInputEvents(const unsigned frame)
+{
+    constexpr float TAU = 2.0f * std::numbers::pi_v<float>;
+
+    ImGuiIO& io = ImGui::GetIO();
+
+    const InputPhase phase = InputPhase((frame / PHASE_FRAMES) % N_INPUT_PHASES);
+    const unsigned t = frame % PHASE_FRAMES;
+    const float p = float(t) / float(PHASE_FRAMES);
+
+    const float left = io.DisplaySize.x * 0.35f;
+    const float top = io.DisplaySize.y * 0.15f;
+    const float width = io.DisplaySize.x * 0.55f;
+    const float height = io.DisplaySize.y * 0.70f;
+
+    const float centreX = left + width / 2;
+    const float centreY = top + height / 2;
+
+    switch (phase) {
+    case InputPhase::Hover: {
+        io.AddMousePosEvent(centreX + std::cos(TAU * p) * width / 2,
+                            centreY + std::sin(TAU * p * 2) * height / 2);
+        break;
+    }
+
+    case InputPhase::Scroll: {
+        io.AddMousePosEvent(centreX, centreY);
+
+        if (t % 4 == 0) {
+            const float v = t < PHASE_FRAMES / 2 ? -1.0f : 1.0f;
+            const float h = t % 8 == 0 ? v : 0.0f;
+            io.AddMouseWheelEvent(h, v);
+        }
+        break;
+    }
+
+    case InputPhase::Zoom: {
+        io.AddMousePosEvent(centreX + width / 4, centreY + height / 4);
+
+        if (t == 0) {
+            io.AddKeyEvent(ImGuiMod_Ctrl, true);
+        }
+        if (t % 10 == 5) {
+            io.AddMouseWheelEvent(0.0f, t < PHASE_FRAMES / 2 ? 1.0f : -1.0f);
+        }
+        if (t == PHASE_FRAMES - 1) {
+            io.AddKeyEvent(ImGuiMod_Ctrl, false);
+        }
+        break;
+    }
+
+    case InputPhase::Paint: {
+        io.AddMousePosEvent(left + width * p, top + height * (0.5f + std::sin(TAU * p) * 0.4f));
+
+        if (t == 0) {
+            io.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+        }
+        if (t == PHASE_FRAMES - 1) {
+            io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+        }
+        break;
+    }
+
+    case InputPhase::Select: {
+        constexpr unsigned CLICK_FRAMES = 6;
+        constexpr unsigned N_COLUMNS = 4;
+
+        const unsigned click = t / CLICK_FRAMES;
+        const float x = left + width * (float(click % N_COLUMNS) + 0.5f) / N_COLUMNS;
+        const float y = top + height * (float(click / N_COLUMNS) + 0.5f) / (PHASE_FRAMES / CLICK_FRAMES / N_COLUMNS + 1);
+
+        io.AddMousePosEvent(x, y);
+
+        if (t % CLICK_FRAMES == 1) {
+            io.AddMouseButtonEvent(ImGuiMouseButton_Left, true);
+        }
+        if (t % CLICK_FRAMES == 2) {
+            io.AddMouseButtonEvent(ImGuiMouseButton_Left, false);
+        }
+        break;
+    }
+    }
+}
+
+// Nearest-rank percentile, `sorted` MUST NOT be empty
+template <typename T>
+static T percentile(const std::vector<T>& sorted, const unsigned p)
+{
+    const size_t rank = (sorted.size() * p + 99) / 100;
+    return sorted.at(std::clamp<size_t>(rank, 1, sorted.size()) - 1);
+}
+
+void BenchScene::printReport(std::ostream& out) const
+{
+    if (_stats.empty()) {
+        out << "No frames processed\n";
+        return;
+    }
+
+    const auto ms = [](const Clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(d).count();
+    };
+
+    auto printTimes = [&](const char* name, auto field) {
+        std::vector<Clock::duration> times;
+        times.reserve(_stats.size());
+        for (const auto& s : _stats) {
+            times.push_back(s.*field);
+        }
+        std::sort(times.begin(), times.end());
+
+        out << std::left << std::setw(12) << name << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << ms(percentile(times, 50)) << " ms p50"
+            << std::setw(10) << ms(percentile(times, 90)) << " ms p90"
+            << std::setw(10) << ms(percentile(times, 99)) << " ms p99"
+            << std::setw(10) << ms(times.back()) << " ms max\n";
+    };
+
+    auto printCounts = [&](const char* name, auto field) {
+        std::vector<unsigned> counts;
+        counts.reserve(_stats.size());
+        for (const auto& s : _stats) {
+            counts.push_back(s.*field);
+        }
+        std::sort(counts.begin(), counts.end());
+
+        out << std::left << std::setw(12) << name << std::right
+            << std::setw(10) << percentile(counts, 50) << "    p50"
+            << std::setw(10) << percentile(counts, 90) << "    p90"
+            << std::setw(10) << percentile(counts, 99) << "    p99"
+            << std::setw(10) << counts.back() << "    max\n";
+    };
+
+    out << _stats.size() << " frames\n";
+
+    printTimes("gui", &FrameStats::guiTime);
+    printTimes("frame", &FrameStats::frameTime);
+    printCounts("draw calls", &FrameStats::drawCalls);
+    printCounts("vertices", &FrameStats::vertices);
+    printCounts("indices", &FrameStats::indices);
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "models/enums.h"
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace UnTech::Gui {
+
+class UnTechEditor;
+
+// Headless GUI rendering benchmark.
+//
+// Opens a resource in its editor, feeds a scripted sequence of
+// hover/scroll/zoom/paint/select inputs into ImGui and records the time taken
+// to process each frame and the size of the ImGui draw data.
+//
+// Designed to be run without a display (SDL offscreen video driver and a
+// software OpenGL renderer, ie: Mesa llvmpipe).
+class BenchScene {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings {
+        ResourceType type;
+        std::u8string resourceName;
+        std::filesystem::path projectFilename;
+        unsigned nFrames;
+    };
+
+    struct FrameStats {
+        // Time taken to process the GUI (processGui and offscreen rendering)
+        Clock::duration guiTime;
+
+        // Time taken to process the GUI and render the ImGui draw data
+        Clock::duration frameTime;
+
+        unsigned drawCalls;
+        unsigned vertices;
+        unsigned indices;
+    };
+
+private:
+    enum class State {
+        WaitingForCompiler,
+        WarmUp,
+        Running,
+        Finished,
+    };
+
+    const Settings _settings;
+
+    State _state;
+    unsigned _frame;
+
+    Clock::time_point _compileStart;
+    Clock::time_point _frameStart;
+    Clock::duration _guiTime;
+
+    std::vector<FrameStats> _stats;
+
+public:
+    // Throws an exception if the arguments are invalid
+    [[nodiscard]] static Settings parseArguments(std::span<const char*> arguments);
+
+    [[nodiscard]] static const char* usage();
+
+    explicit BenchScene(Settings settings);
+
+    const Settings& settings() const { return _settings; }
+
+    bool finished() const { return _state == State::Finished; }
+
+    // MUST be called before `ImGui::NewFrame()`.
+    // Throws an exception if the resource cannot be opened.
+    void startFrame(UnTechEditor& editor);
+
+    // MUST be called before the ImGui draw data is rendered.
+    void guiProcessed();
+
+    // MUST be called after the ImGui draw data is rendered.
+    void endFrame();
+
+    void printReport(std::ostream& out) const;
+
+private:
+    void queueInputEvents(unsigned frame);
+};
+
+}
@@ -63,7 +63,7 @@ void BackgroundImageEditorData::updateSelection()
 BackgroundImageEditorGui::BackgroundImageEditorGui()
     : AbstractEditorGui("##BG image editor")
     , _data(nullptr)
-    , _imageTexture()
+    , _imageTexture(TextureCache::loadPngImage({}))
     , _textureValid(false)
 {
 }
@@ -148,12 +148,14 @@ void BackgroundImageEditorGui::backgroundImageGui(const Project::ProjectFile& pr
 
         const ImVec2& zoom = Style::backgroundImageZoom.zoom();
 
-        const ImVec2 imageSize(_imageTexture.width() * zoom.x, _imageTexture.height() * zoom.y);
+        const Texture& texture = _imageTexture->texture();
+
+        const ImVec2 imageSize(texture.width() * zoom.x, texture.height() * zoom.y);
         const ImVec2 screenOffset = captureMouseExpandCanvasAndCalcScreenPos("PaletteImage", imageSize);
 
         auto* drawList = ImGui::GetWindowDrawList();
 
-        drawList->AddImage(_imageTexture.imguiTextureId(), screenOffset, screenOffset + imageSize);
+        drawList->AddImage(texture.imguiTextureId(), screenOffset, screenOffset + imageSize);
         _invalidTiles.draw(drawList, zoom, screenOffset);
 
         Style::backgroundImageZoom.processMouseWheel();
@@ -184,7 +186,7 @@ void BackgroundImageEditorGui::updateImageTexture()
 
     // ::TODO draw tileset from projectData::
 
-    _imageTexture.loadPngImage(bi.imageFilename);
+    _imageTexture = TextureCache::loadPngImage(bi.imageFilename);
 
     _textureValid = true;
 }
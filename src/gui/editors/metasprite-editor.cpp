@@ -419,18 +419,20 @@ MetaSpriteEditorGui::MetaSpriteEditorGui()
     , _selectedEditorBgColor(DEFAULT_BACKGROUND_COLOR)
     , _graphics()
     , _paletteTexture(PALETTE_TEXTURE_WIDTH, PALETTE_TEXTURE_HEIGHT)
-    , _tilesetTexture()
+    , _tileset()
     , _paletteImage(PALETTE_TEXTURE_WIDTH, PALETTE_TEXTURE_HEIGHT)
-    , _tilesetImage()
+    , _tilesetIndexes()
     , _paletteBackgroundColor(IM_COL32_WHITE)
     , _smallTilesetUvSize()
     , _largeTilesetUvSize()
     , _smallTilesetUVmax()
     , _largeTilesetUVmax()
+    , _largeTilesetYOffset(0)
     , _sidebar{ 550, 300, 300 }
     , _bottombar{ 300, 200, 300 }
     , _paletteValid(false)
     , _tilesetValid(false)
+    , _tilesetPaletteValid(false)
 {
 }
 
@@ -446,6 +448,7 @@ void MetaSpriteEditorGui::resetState()
 
     _paletteValid = false;
     _tilesetValid = false;
+    _tilesetPaletteValid = false;
 
     _colorSel = INT_MAX;
     _paletteState = PaletteState::EDIT_COLOR;
@@ -914,7 +917,7 @@ void MetaSpriteEditorGui::drawTileset(const char* label, typename TilesetPolicy:
         drawList->AddRectFilled(partialPos, partialPos + partialSize, _paletteBackgroundColor);
     }
 
-    drawList->AddImage(_tilesetTexture.imguiTextureId(), offset, offset + imageSize, uv0, uv1);
+    drawList->AddImage(_tileset.texture().imguiTextureId(), offset, offset + imageSize, uv0, uv1);
 
     // Draw grid
     {
@@ -989,11 +992,14 @@ void MetaSpriteEditorGui::drawTileset(const char* label, typename TilesetPolicy:
                     _editedTiles.clear();
                 }
                 if (ImGui::IsMouseDown(0)) {
-                    tileset->at(tileId).setPixel(p.x % TILE_SIZE, p.y % TILE_SIZE, _colorSel);
+                    auto& tile = tileset->at(tileId);
+                    tile.setPixel(p.x % TILE_SIZE, p.y % TILE_SIZE, _colorSel);
                     _editedTiles.insert(tileId);
 
                     // Immediatly display changed tile data
-                    _tilesetValid = false;
+                    const unsigned yOffset = TilesetPolicy::OBJ_SIZE == ObjectSize::SMALL ? 0 : _largeTilesetYOffset;
+                    _tileset.setIndexes((tileId % TILES_PER_ROW) * TILE_SIZE, yOffset + (tileId / TILES_PER_ROW) * TILE_SIZE,
+                                        usize(TILE_SIZE, TILE_SIZE), tile.data().data());
                 }
             } break;
 
@@ -1028,7 +1034,7 @@ void MetaSpriteEditorGui::tilesetGui()
     // AlwaysVerticalScrollbar fixes a graphical glitch where the tileset zoom changes every display frame.
     ImGui::BeginChild("Scroll", ImVec2(0, 0), false, ImGuiWindowFlags_AlwaysVerticalScrollbar);
 
-    const int z = std::max<int>(1, ImGui::GetContentRegionAvail().x / _tilesetTexture.width());
+    const int z = std::max<int>(1, ImGui::GetContentRegionAvail().x / TILESET_IMAGE_WIDTH);
 
     auto* drawList = ImGui::GetWindowDrawList();
 
@@ -1057,7 +1063,7 @@ inline void MetaSpriteEditorGui::drawAnimationFrame(const ImVec2& pos, const ImV
     auto* drawList = ImGui::GetWindowDrawList();
 
     if (showFrameObjects) {
-        const ImTextureID textureId = _tilesetTexture.imguiTextureId();
+        const ImTextureID textureId = _tileset.texture().imguiTextureId();
 
         for (auto [i, obj] : reverse_enumerate(frame.objects)) {
             bool valid = false;
@@ -1168,7 +1174,7 @@ void MetaSpriteEditorGui::frameEditorGui()
     _graphics.drawBackgroundColor(drawList, bgColor);
     _graphics.drawBoundedCrosshair(drawList, 0, 0, Style::metaSpriteCrosshairColor);
 
-    const ImTextureID textureId = _tilesetTexture.imguiTextureId();
+    const ImTextureID textureId = _tileset.texture().imguiTextureId();
 
     if (showFrameObjects) {
         for (auto [i, obj] : reverse_enumerate(frame->objects)) {
@@ -1282,6 +1288,7 @@ void MetaSpriteEditorGui::processGui(const Project::ProjectFile& projectFile, co
     updateExportOderTree(fs, projectFile);
     updatePaletteTexture();
     updateTilesetTexture();
+    updateTilesetPalette();
 
     splitterSidebarRight(
         "##splitter", &_sidebar,
@@ -1356,7 +1363,7 @@ void MetaSpriteEditorGui::updateSelection()
     assert(_data);
 
     if (_data->palettesSel.isSelectionChanging()) {
-        _tilesetValid = false;
+        _tilesetPaletteValid = false;
     }
 
     if (_paletteState == PaletteState::DRAW_TILES) {
@@ -1395,13 +1402,11 @@ void MetaSpriteEditorGui::updatePaletteTexture()
     _paletteTexture.replace(_paletteImage);
 
     _paletteValid = true;
-    _tilesetValid = false;
+    _tilesetPaletteValid = false;
 }
 
 void MetaSpriteEditorGui::updateTilesetTexture()
 {
-    static const Snes::Palette4bpp BLANK_PALETTE;
-
     assert(_data);
     auto& fs = _data->data;
 
@@ -1409,46 +1414,57 @@ void MetaSpriteEditorGui::updateTilesetTexture()
         return;
     }
 
-    std::span<const rgba> palette;
-    {
-        const auto palIndex = _data->palettesSel.selectedIndex();
-
-        if (palIndex < fs.palettes.size()
-            && palIndex < PALETTE_TEXTURE_HEIGHT) {
-
-            assert(_paletteImage.size().width == N_PALETTE_COLORS);
-            palette = _paletteImage.scanline(palIndex);
-        }
-    }
-
     const unsigned nSmallRows = (std::max<unsigned>(1, fs.smallTileset.size()) - 1) / SMALL_TILES_PER_ROW + 1;
     const unsigned nLargeRows = (std::max<unsigned>(1, fs.largeTileset.size()) - 1) / LARGE_TILES_PER_ROW + 1;
 
     const usize tilesetSize(TILESET_IMAGE_WIDTH,
                             nextPowerOfTwo(nSmallRows * SMALL_TILE_SIZE + nLargeRows * LARGE_TILE_SIZE));
 
-    if (_tilesetImage == nullptr || _tilesetImage->size() != tilesetSize) {
-        _tilesetImage = std::make_unique<Image>(tilesetSize);
+    if (_tilesetIndexes.size() != tilesetSize) {
+        _tilesetIndexes = grid<uint8_t>(tilesetSize);
     }
     else {
-        _tilesetImage->fill(rgba());
+        std::fill(_tilesetIndexes.begin(), _tilesetIndexes.end(), 0);
     }
 
+    _largeTilesetYOffset = nSmallRows * SMALL_TILE_SIZE;
+
     _smallTilesetUvSize = ImVec2(float(SMALL_TILE_SIZE) / tilesetSize.width, float(SMALL_TILE_SIZE) / tilesetSize.height);
     _largeTilesetUvSize = ImVec2(float(LARGE_TILE_SIZE) / tilesetSize.width, float(LARGE_TILE_SIZE) / tilesetSize.height);
     _smallTilesetUVmax = ImVec2(1.0f, _smallTilesetUvSize.y * nSmallRows);
     _largeTilesetUVmax = ImVec2(1.0f, _smallTilesetUVmax.y + _largeTilesetUvSize.y * nLargeRows);
 
-    if (!palette.empty()) {
-        constexpr size_t stride = TILESET_IMAGE_WIDTH;
-        assert(stride == _tilesetImage->pixelsPerScanline());
-        assert(palette.size() == N_PALETTE_COLORS);
+    Snes::drawTileset_indexed(_tilesetIndexes, 0, fs.smallTileset);
+    Snes::drawTileset_indexed(_tilesetIndexes, _largeTilesetYOffset, fs.largeTileset);
+
+    _tileset.setIndexes(_tilesetIndexes);
+
+    _tilesetValid = true;
+}
+
+// Only uploads the selected palette, the tileset is converted to RGBA by the GPU.
+void MetaSpriteEditorGui::updateTilesetPalette()
+{
+    assert(_data);
+    auto& fs = _data->data;
 
-        Snes::drawTileset_transparent(*_tilesetImage, 0, fs.smallTileset, palette);
-        Snes::drawTileset_transparent(*_tilesetImage, nSmallRows * SMALL_TILE_SIZE, fs.largeTileset, palette);
+    if (_tilesetPaletteValid) {
+        return;
     }
 
-    _tilesetTexture.replace(*_tilesetImage);
+    std::span<const rgba> palette;
+    {
+        const auto palIndex = _data->palettesSel.selectedIndex();
+
+        if (palIndex < fs.palettes.size()
+            && palIndex < PALETTE_TEXTURE_HEIGHT) {
+
+            assert(_paletteImage.size().width == N_PALETTE_COLORS);
+            palette = _paletteImage.scanline(palIndex);
+        }
+    }
+
+    _tileset.setPalette(palette);
 
     // ALso update background color
     if (!palette.empty()) {
@@ -1458,7 +1474,7 @@ void MetaSpriteEditorGui::updateTilesetTexture()
         _paletteBackgroundColor = 0;
     }
 
-    _tilesetValid = true;
+    _tilesetPaletteValid = true;
 }
 
 }
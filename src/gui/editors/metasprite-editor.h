@@ -11,6 +11,7 @@
 #include "gui/graphics/aabb-graphics.h"
 #include "gui/imgui.h"
 #include "gui/selection.h"
+#include "gui/shaders.h"
 #include "gui/splitter.h"
 #include "gui/texture.h"
 #include "models/common/vectorset.h"
@@ -75,10 +76,10 @@ private:
 
     AabbGraphics _graphics;
     Texture _paletteTexture;
-    Texture _tilesetTexture;
+    Shaders::PalettedTileset _tileset;
 
     Image _paletteImage;
-    std::unique_ptr<Image> _tilesetImage;
+    grid<uint8_t> _tilesetIndexes;
 
     ImU32 _paletteBackgroundColor;
 
@@ -86,6 +87,7 @@ private:
     ImVec2 _largeTilesetUvSize;
     ImVec2 _smallTilesetUVmax;
     ImVec2 _largeTilesetUVmax;
+    unsigned _largeTilesetYOffset;
 
     SplitterBarState _sidebar;
     SplitterBarState _bottombar;
@@ -93,6 +95,7 @@ private:
 public:
     bool _paletteValid;
     bool _tilesetValid;
+    bool _tilesetPaletteValid;
 
     static const ImVec2 _paletteUvSize;
 
@@ -137,6 +140,7 @@ private:
 
     void updatePaletteTexture();
     void updateTilesetTexture();
+    void updateTilesetPalette();
     void updateSelection();
 
     template <auto FieldPtr>
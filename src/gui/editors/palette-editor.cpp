@@ -65,7 +65,7 @@ PaletteEditorGui::PaletteEditorGui()
     : AbstractEditorGui("##Palette editor")
     , _data(nullptr)
     , _animationTimer()
-    , _imageTexture()
+    , _imageTexture(TextureCache::loadPngImage({}))
     , _frameId(0)
     , _textureValid(false)
 {
@@ -128,9 +128,11 @@ void PaletteEditorGui::paletteGui()
     ImGui::Separator();
     ImGui::Spacing();
 
-    const auto rowsPerFrame = clamp<unsigned>(palette.rowsPerFrame, 1, _imageTexture.height());
+    const Texture& texture = _imageTexture->texture();
+
+    const auto rowsPerFrame = clamp<unsigned>(palette.rowsPerFrame, 1, texture.height());
     const unsigned firstFrame = palette.skipFirstFrame ? 1 : 0;
-    const unsigned nFrames = std::max<unsigned>(1, _imageTexture.height() / rowsPerFrame - firstFrame);
+    const unsigned nFrames = std::max<unsigned>(1, texture.height() / rowsPerFrame - firstFrame);
 
     {
         if (ImGui::ToggledButton("Play", _animationTimer.isActive())) {
@@ -173,12 +175,12 @@ void PaletteEditorGui::paletteGui()
             constexpr float lineWidth = 2.0f;
             constexpr float zoom = 24;
 
-            const ImVec2 imageSize(_imageTexture.width() * zoom, _imageTexture.height() * zoom);
+            const ImVec2 imageSize(texture.width() * zoom, texture.height() * zoom);
             const ImVec2 screenOffset = captureMouseExpandCanvasAndCalcScreenPos("Image", imageSize);
 
             auto* drawList = ImGui::GetWindowDrawList();
 
-            drawList->AddImage(_imageTexture.imguiTextureId(), screenOffset, screenOffset + imageSize);
+            drawList->AddImage(texture.imguiTextureId(), screenOffset, screenOffset + imageSize);
 
             const float x1 = screenOffset.x - zoom;
             const float x2 = x1 + imageSize.x + 2 * zoom;
@@ -191,22 +193,22 @@ void PaletteEditorGui::paletteGui()
             }
             drawList->AddLine(ImVec2(x1, y), ImVec2(x2, y), Style::paletteRowLineColor, lineWidth);
 
-            if ((firstFrame + nFrames) * rowsPerFrame != _imageTexture.height()) {
+            if ((firstFrame + nFrames) * rowsPerFrame != texture.height()) {
                 drawList->AddRectFilled(ImVec2(x1, y + lineWidth / 2), ImVec2(x2, screenOffset.y + imageSize.y), Style::invalidFillColor);
             }
         }
         else {
             constexpr float zoom = 48;
 
-            const ImVec2 imageSize(_imageTexture.width() * zoom, rowsPerFrame * zoom);
+            const ImVec2 imageSize(texture.width() * zoom, rowsPerFrame * zoom);
             const ImVec2 screenOffset = captureMouseExpandCanvasAndCalcScreenPos("FrameImage", imageSize);
 
             auto* drawList = ImGui::GetWindowDrawList();
 
-            const ImVec2 uvMin(0.0f, float((_frameId + firstFrame) * rowsPerFrame) / _imageTexture.height());
-            const ImVec2 uvMax(1.0f, float((_frameId + firstFrame + 1) * rowsPerFrame) / _imageTexture.height());
+            const ImVec2 uvMin(0.0f, float((_frameId + firstFrame) * rowsPerFrame) / texture.height());
+            const ImVec2 uvMax(1.0f, float((_frameId + firstFrame + 1) * rowsPerFrame) / texture.height());
 
-            drawList->AddImage(_imageTexture.imguiTextureId(), screenOffset, screenOffset + imageSize, uvMin, uvMax);
+            drawList->AddImage(texture.imguiTextureId(), screenOffset, screenOffset + imageSize, uvMin, uvMax);
         }
 
         ImGui::EndChild();
@@ -233,7 +235,7 @@ void PaletteEditorGui::updateImageTexture()
         return;
     }
 
-    _imageTexture.loadPngImage(palette.paletteImageFilename);
+    _imageTexture = TextureCache::loadPngImage(palette.paletteImageFilename);
 
     _textureValid = true;
 }
@@ -8,7 +8,7 @@
 
 #include "gui/abstract-editor.h"
 #include "gui/animation-timer.h"
-#include "gui/texture.h"
+#include "gui/texture-cache.h"
 #include "models/project/project.h"
 
 namespace UnTech::Gui {
@@ -36,7 +36,7 @@ private:
 
     SingleAnimationTimer _animationTimer;
 
-    Texture _imageTexture;
+    std::shared_ptr<const CachedTexture> _imageTexture;
     int _frameId;
 
 public:
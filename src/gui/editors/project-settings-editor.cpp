@@ -109,6 +109,7 @@ void ProjectSettingsEditorGui::projectSettingsGui()
         bool edited = false;
 
         edited |= Cell_Formatted("Max Room Data Size", &roomSettings.roomDataSize, "%u bytes");
+        edited |= Cell_Formatted("Map Block Width", &roomSettings.mapBlockWidth, "%u columns");
 
         if (edited) {
             EditorActions<AP::RoomSettings>::editorDataEdited(_data);
@@ -29,6 +29,8 @@ using EntityDragDropType = size_t;
 
 static constexpr unsigned METATILE_SIZE_PX = MetaTiles::METATILE_SIZE_PX;
 
+static constexpr int OBJECT_GRID_CELL_SIZE = 64;
+
 unsigned RoomEditorGui::playerId = 0;
 
 bool RoomEditorGui::showEntrances = true;
@@ -50,6 +52,8 @@ struct RoomEditorData::AP {
         {
             return fileListData(&projectFile.rooms, itemIndex.index);
         }
+
+        constexpr static auto validFlag = &RoomEditorGui::_objectGridValid;
     };
 
     struct Scene : public Room {
@@ -383,7 +387,12 @@ RoomEditorGui::RoomEditorGui()
     , _graphics()
     , _entityTexture()
     , _entityGraphics(nullptr)
+    , _objectGrid()
+    , _gridQuery()
+    , _objectVisible()
     , _scenesData(nullptr)
+    , _compiledRoom(nullptr)
+    , _sizeReport(std::nullopt)
     , _sidebar{ 360, 300, 300 }
     , _minimapRight_sidebar{ 350, 280, 400 }
     , _minimapRight_bottombar{ 350, 100, 100 }
@@ -394,6 +403,7 @@ RoomEditorGui::RoomEditorGui()
     , _minimapOnRight(true)
     , _entityTextureWindowOpen(false)
     , _mtTilesetValid(false)
+    , _objectGridValid(false)
 {
 }
 
@@ -414,7 +424,10 @@ void RoomEditorGui::resetState()
     setEditMode(EditMode::SelectObjects);
 
     _mtTilesetValid = false;
+    _objectGridValid = false;
     _scenesData = nullptr;
+    _compiledRoom = nullptr;
+    _sizeReport = std::nullopt;
 
     _showEntitiesDropdownWindow = false;
 }
@@ -502,6 +515,8 @@ void RoomEditorGui::propertiesGui(const Project::ProjectFile& projectFile)
         }
     }
 
+    sizeReportGui(projectFile);
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::TextUnformatted(u8"Entrances:");
@@ -574,12 +589,15 @@ void RoomEditorGui::propertiesGui(const Project::ProjectFile& projectFile)
 
             ImGui::Indent();
 
+            // The table is clipped, the selection function is not called for every entity.
+            const unsigned firstEntityId = entityId;
+            entityId += group.entities.size();
+
             apTable_data_custom<AP::EntityEntries>(
                 _data,
                 std::make_tuple(groupIndex),
                 [&](auto* sel, auto index) {
-                    const std::u8string selLabel = stringBuilder(entityId);
-                    entityId++;
+                    const std::u8string selLabel = stringBuilder(firstEntityId + index);
                     ImGui::Selectable(u8Cast(selLabel), sel, groupIndex, index);
                 },
 
@@ -737,23 +755,88 @@ void RoomEditorGui::entityDropTarget(ImDrawList* drawList)
     }
 }
 
+void RoomEditorGui::updateVisibleObjects(ImDrawList* drawList)
+{
+    assert(_entityGraphics);
+    assert(_data);
+    const auto& room = _data->data;
+
+    const unsigned nGroups = std::min<size_t>(_data->entityEntriesSel.MAX_GROUP_SIZE, room.entityGroups.size());
+
+    size_t nObjects = room.entrances.size();
+    for (const auto groupIndex : range(nGroups)) {
+        nObjects += room.entityGroups.at(groupIndex).entities.size();
+    }
+
+    if (!_graphics.isNonInteractiveState()) {
+        // The selected objects are moved in place when dragged.
+        // Rebuild the grid after the drag has finished.
+        _objectGridValid = false;
+
+        _objectVisible.assign(nObjects, true);
+        return;
+    }
+
+    if (!_objectGridValid || _objectGrid.nItems() != nObjects) {
+        std::vector<TwoPointRect> rects;
+        rects.reserve(nObjects);
+
+        auto addObject = [&](const auto& position, const DrawEntitySettings& ds) {
+            const int x = int(position.x);
+            const int y = int(position.y);
+
+            rects.emplace_back(x + std::min(ds.hitboxRect.x1, ds.imageRect.x1),
+                               x + std::max(ds.hitboxRect.x2, ds.imageRect.x2),
+                               y + std::min(ds.hitboxRect.y1, ds.imageRect.y1),
+                               y + std::max(ds.hitboxRect.y2, ds.imageRect.y2));
+        };
+
+        for (const auto& entrance : room.entrances) {
+            addObject(entrance.position, _entityGraphics->settingsForPlayer(playerId));
+        }
+        for (const auto groupIndex : range(nGroups)) {
+            for (const auto& entity : room.entityGroups.at(groupIndex).entities) {
+                addObject(entity.position, _entityGraphics->settingsForEntity(entity.entityId));
+            }
+        }
+
+        _objectGrid.build(rects, OBJECT_GRID_CELL_SIZE);
+        _objectGridValid = true;
+    }
+
+    const point clipMin = _graphics.toPoint(drawList->GetClipRectMin());
+    const point clipMax = _graphics.toPoint(drawList->GetClipRectMax());
+
+    _gridQuery.clear();
+    _objectGrid.query(TwoPointRect(clipMin.x, clipMax.x, clipMin.y, clipMax.y), _gridQuery);
+
+    _objectVisible.assign(nObjects, false);
+    for (const auto id : _gridQuery) {
+        _objectVisible.at(id) = true;
+    }
+}
+
 void RoomEditorGui::drawObjects(ImDrawList* drawList)
 {
     assert(_entityGraphics);
     assert(_data);
     auto& room = _data->data;
 
-    const ImTextureID textureId = _entityTexture.imguiTextureId();
+    updateVisibleObjects(drawList);
 
-    // NOTE: pushing a textureId to the drawlist prevents me from drawing filled rects
-    drawList->PushTextureID(textureId);
+    unsigned objectId = 0;
 
     if (showEntrances) {
         for (const auto& entrance : room.entrances) {
-            _graphics.drawEntity(drawList, &entrance.position,
-                                 textureId, _entityGraphics->settingsForPlayer(playerId), IM_COL32_WHITE);
+            if (_objectVisible.at(objectId)) {
+                _graphics.batchEntity(&entrance.position, _entityGraphics->settingsForPlayer(playerId), IM_COL32_WHITE);
+            }
+            objectId++;
         }
     }
+    else {
+        objectId += room.entrances.size();
+    }
 
     if (showEntities) {
         const unsigned nGroups = std::min<size_t>(_data->entityEntriesSel.MAX_GROUP_SIZE, room.entityGroups.size());
@@ -765,14 +848,15 @@ void RoomEditorGui::drawObjects(ImDrawList* drawList)
             const ImU32 tint = groupEnabled ? IM_COL32_WHITE : Style::disabledEntityGroupTint;
 
             for (const auto& entity : group.entities) {
-                _graphics.drawEntity(drawList, &entity.position,
-                                     textureId, _entityGraphics->settingsForEntity(entity.entityId),
-                                     tint);
+                if (_objectVisible.at(objectId)) {
+                    _graphics.batchEntity(&entity.position, _entityGraphics->settingsForEntity(entity.entityId), tint);
+                }
+                objectId++;
             }
         }
     }
 
-    drawList->PopTextureID();
+    _graphics.drawEntityBatch(drawList, _entityTexture.imguiTextureId());
 
     if (showScriptTriggers) {
         for (const auto& st : room.scriptTriggers) {
@@ -793,13 +877,17 @@ void RoomEditorGui::drawAndEditObjects(ImDrawList* drawList)
     assert(_data);
     auto& room = _data->data;
 
-    const ImTextureID textureId = _entityTexture.imguiTextureId();
-    // NOTE: Cannot push textureId to drawList - it prevents me from drawing filled rects.
+    updateVisibleObjects(drawList);
+
+    unsigned objectId = 0;
 
     if (showEntrances) {
         for (auto [i, entrance] : enumerate(room.entrances)) {
-            _graphics.addEntity(drawList, &entrance.position,
-                                textureId, _entityGraphics->settingsForPlayer(playerId),
+            if (!_objectVisible.at(objectId++)) {
+                continue;
+            }
+
+            _graphics.addEntity(&entrance.position, _entityGraphics->settingsForPlayer(playerId),
                                 Style::entranceFillColor, Style::entranceOutlineColor, IM_COL32_WHITE,
                                 &_data->entrancesSel, i);
 
@@ -808,6 +896,9 @@ void RoomEditorGui::drawAndEditObjects(ImDrawList* drawList)
             }
         }
     }
+    else {
+        objectId += room.entrances.size();
+    }
 
     if (showEntities) {
         const unsigned nGroups = std::min<size_t>(_data->entityEntriesSel.MAX_GROUP_SIZE, room.entityGroups.size());
@@ -819,8 +910,11 @@ void RoomEditorGui::drawAndEditObjects(ImDrawList* drawList)
                 // No entity groups are selected or the  groupIndex is the selected group
 
                 for (auto [i, entity] : enumerate(group.entities)) {
-                    _graphics.addEntity(drawList, &entity.position,
-                                        textureId, _entityGraphics->settingsForEntity(entity.entityId),
+                    if (!_objectVisible.at(objectId++)) {
+                        continue;
+                    }
+
+                    _graphics.addEntity(&entity.position, _entityGraphics->settingsForEntity(entity.entityId),
                                         Style::entityFillColor, Style::entityOutlineColor, IM_COL32_WHITE,
                                         &childSel, i);
                     if (_graphics.isHoveredAndNotEditing()) {
@@ -844,14 +938,17 @@ void RoomEditorGui::drawAndEditObjects(ImDrawList* drawList)
                 // A group is selected and groupIndex is not the selected group
 
                 for (const auto& entity : group.entities) {
-                    _graphics.drawEntity(drawList, &entity.position,
-                                         textureId, _entityGraphics->settingsForEntity(entity.entityId),
-                                         Style::disabledEntityGroupTint);
+                    if (_objectVisible.at(objectId++)) {
+                        _graphics.batchEntity(&entity.position, _entityGraphics->settingsForEntity(entity.entityId),
+                                              Style::disabledEntityGroupTint);
+                    }
                 }
             }
         }
     }
 
+    _graphics.drawEntityBatch(drawList, _entityTexture.imguiTextureId());
+
     if (showScriptTriggers) {
         const TwoPointRect bounds(0, room.map.width() * METATILE_SIZE_PX, 0, room.map.height() * METATILE_SIZE_PX);
 
@@ -890,7 +987,9 @@ void RoomEditorGui::editorGui()
         ImGui::SameLine(0.0f, 12.0f);
 
         ImGui::SetNextItemWidth(180);
-        ImGui::SingleSelectionNamedListCombo("##PlayerId", &playerId, _entityGraphics->players, false);
+        if (ImGui::SingleSelectionNamedListCombo("##PlayerId", &playerId, _entityGraphics->players, false)) {
+            _objectGridValid = false;
+        }
         if (ImGui::IsItemHovered()) {
             ImGui::ShowTooltip(u8"Player Entity");
         }
@@ -996,6 +1095,7 @@ void RoomEditorGui::processGui(const Project::ProjectFile& projectFile, const Pr
     updateMapAndProcessAnimations();
     updateEntityGraphics();
     updateTilesetData(projectFile, projectData);
+    updateSizeReport(projectData);
 
     splitterSidebarRight(
         "##splitter", &_sidebar,
@@ -1072,6 +1172,30 @@ void RoomEditorGui::processGui(const Project::ProjectFile& projectFile, const Pr
         });
 }
 
+void RoomEditorGui::sizeReportGui(const Project::ProjectFile& projectFile)
+{
+    const auto& roomSettings = projectFile.projectSettings.roomSettings;
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::TextUnformatted(u8"Compiled Size:");
+    ImGui::Indent();
+
+    if (_sizeReport) {
+        const auto& r = *_sizeReport;
+
+        ImGui::Text("Room Data (RAM): %zu / %u bytes", r.roomDataBytes, roomSettings.roomDataSize);
+        ImGui::Text("ROM: %zu bytes", r.romBytes);
+        ImGui::Text("Map Blocks: %zu", r.nMapBlocks);
+        ImGui::Text("Largest Decompression: %zu bytes", r.largestDecompression);
+    }
+    else {
+        ImGui::TextUnformatted(u8"Room has not been compiled");
+    }
+
+    ImGui::Unindent();
+}
+
 void RoomEditorGui::processExtraWindows(const Project::ProjectFile&, const Project::ProjectData&)
 {
     entitiesDropdownWindow();
@@ -1117,6 +1241,7 @@ void RoomEditorGui::updateEntityGraphics()
         _entityTexture.replace(eg->image);
 
         _entityGraphics = std::move(eg);
+        _objectGridValid = false;
 
         if (playerId >= _entityGraphics->players.size()) {
             playerId = 0;
@@ -1124,6 +1249,28 @@ void RoomEditorGui::updateEntityGraphics()
     }
 }
 
+void RoomEditorGui::updateSizeReport(const Project::ProjectData& projectData)
+{
+    assert(_data);
+
+    auto room = projectData.rooms.at(_data->itemIndex().index);
+
+    if (_compiledRoom != room) {
+        _compiledRoom = std::move(room);
+        _sizeReport = std::nullopt;
+
+        // Only compress the room data when the compiled room changes
+        if (_compiledRoom) {
+            try {
+                _sizeReport = Rooms::roomSizeReport(*_compiledRoom, _compiledRoom->exportSnesData());
+            }
+            catch (const std::exception&) {
+                // The room data is too large to export
+            }
+        }
+    }
+}
+
 void RoomEditorGui::updateTilesetData(const Project::ProjectFile& projectFile,
                                       const Project::ProjectData& projectData)
 {
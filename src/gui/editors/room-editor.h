@@ -10,9 +10,11 @@
 #include "gui/editors/abstract-metatile-editor.h"
 #include "gui/graphics/aabb-graphics.h"
 #include "gui/graphics/invalid-room-tile-graphics.h"
+#include "gui/graphics/uniform-grid-index.h"
 #include "gui/selection.h"
 #include "gui/splitter.h"
 #include "models/project/project.h"
+#include <optional>
 
 namespace UnTech::Gui {
 
@@ -73,9 +75,23 @@ private:
     Texture _entityTexture;
     std::shared_ptr<const EntityGraphics> _entityGraphics;
 
+    // Spatial index of the entrances and entities.
+    // Object ids are the entrance index, followed by the entities (in group order).
+    UniformGridIndex _objectGrid;
+
+    std::vector<unsigned> _gridQuery;
+
+    // Indexed by object id.
+    // Objects outside the visible region of the editor are not drawn or hit-tested.
+    std::vector<bool> _objectVisible;
+
     // Used to determine if the compiled scenes data has changed.
     std::shared_ptr<const Resources::CompiledScenesData> _scenesData;
 
+    // Used to determine if the compiled room data has changed.
+    std::shared_ptr<const Rooms::RoomData> _compiledRoom;
+    std::optional<Rooms::RoomSizeReport> _sizeReport;
+
     grid<uint8_t> _scratchpad;
 
     InvalidRoomTileGraphics _invalidTiles;
@@ -96,6 +112,7 @@ private:
 
 public:
     bool _mtTilesetValid;
+    bool _objectGridValid;
 
     static unsigned playerId;
 
@@ -133,6 +150,7 @@ protected:
 
 private:
     void propertiesGui(const Project::ProjectFile& projectFile);
+    void sizeReportGui(const Project::ProjectFile& projectFile);
     void scratchpadGui();
 
     void editorGui();
@@ -142,10 +160,13 @@ private:
     void entitiesDropdownWindow();
     void entityDropTarget(ImDrawList* drawList);
 
+    void updateVisibleObjects(ImDrawList* drawList);
+
     void drawObjects(ImDrawList* drawList);
     void drawAndEditObjects(ImDrawList* drawList);
 
     void updateEntityGraphics();
+    void updateSizeReport(const Project::ProjectData& projectData);
     void updateTilesetData(const Project::ProjectFile& projectFile,
                            const Project::ProjectData& projectData);
 };
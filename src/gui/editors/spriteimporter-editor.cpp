@@ -12,11 +12,9 @@
 #include "gui/splitter.hpp"
 #include "gui/style.h"
 #include "models/common/bit.h"
-#include "models/common/imagecache.h"
 #include "models/metasprite/metasprite-error.h"
 #include "vendor/imgui/imgui.h"
 #include <algorithm>
-#include <unordered_set>
 
 namespace UnTech::Gui {
 
@@ -27,6 +25,8 @@ constexpr static unsigned MINIMIM_FRAME_SIZE = 16;
 
 constexpr static int IMAGE_PADDING = 4;
 
+constexpr static int FRAME_GRID_CELL_SIZE = 64;
+
 // MetaSpriteEditor Action Policies
 struct SpriteImporterEditorData::AP {
     struct FrameSet {
@@ -50,6 +50,8 @@ struct SpriteImporterEditorData::AP {
             }
             return nullptr;
         }
+
+        constexpr static auto validFlag = &SpriteImporterEditorGui::_frameGridValid;
     };
 
     struct ExportOrder : public FrameSet {
@@ -275,11 +277,14 @@ SpriteImporterEditorGui::SpriteImporterEditorGui()
     : AbstractMetaSpriteEditorGui("##SI editor")
     , _data(nullptr)
     , _graphics()
-    , _imageTexture()
+    , _imageTexture(TextureCache::loadPngImage({}))
+    , _frameGrid()
+    , _gridQuery()
     , _transparentColorCombo()
     , _sidebar{ 550, 400, 250 }
     , _imageValid(false)
     , _transparentColorComboValid(false)
+    , _frameGridValid(false)
 {
 }
 
@@ -295,6 +300,7 @@ void SpriteImporterEditorGui::resetState()
 
     _imageValid = false;
     _transparentColorComboValid = false;
+    _frameGridValid = false;
 
     _graphics.resetState();
 }
@@ -517,7 +523,7 @@ void SpriteImporterEditorGui::framePropertiesGui(const Project::ProjectFile& pro
             else {
                 ImGui::LabelText("Grid Location", " ");
 
-                const auto& imgSize = _imageTexture.size();
+                const auto& imgSize = _imageTexture->texture().size();
                 const usize bounds = (imgSize.width != 0 && imgSize.height != 0) ? imgSize : usize(4096, 4096);
 
                 loEdited |= Cell("AABB", &frame.locationOverride.value(), bounds);
@@ -619,9 +625,10 @@ void SpriteImporterEditorGui::drawAnimationFrame(const ImVec2& drawPos, ImVec2 z
     }
 
     if (showFrameObjects) {
-        const auto textureId = _imageTexture.imguiTextureId();
+        const Texture& texture = _imageTexture->texture();
+        const auto textureId = texture.imguiTextureId();
 
-        const ImVec2 uv(1.0f / _imageTexture.width(), 1.0f / _imageTexture.height());
+        const ImVec2 uv(1.0f / texture.width(), 1.0f / texture.height());
 
         for (auto [i, obj] : reverse_enumerate(frame.objects)) {
             const unsigned x = frameAabb.x + obj.location.x;
@@ -732,7 +739,8 @@ void SpriteImporterEditorGui::frameEditorGui()
     auto& fs = _data->data;
     auto& frames = fs.frames;
 
-    const rect graphicsRect(-IMAGE_PADDING, -IMAGE_PADDING, _imageTexture.width() + 2 * IMAGE_PADDING, _imageTexture.height() + 2 * IMAGE_PADDING);
+    const usize& imageSize = _imageTexture->texture().size();
+    const rect graphicsRect(-IMAGE_PADDING, -IMAGE_PADDING, imageSize.width + 2 * IMAGE_PADDING, imageSize.height + 2 * IMAGE_PADDING);
 
     {
         undoStackButtons();
@@ -783,7 +791,12 @@ void SpriteImporterEditorGui::frameEditorGui()
                 _data->framesSel.clearSelection();
             }
 
-            for (auto [frameIndex, frame] : const_enumerate(frames)) {
+            _gridQuery.clear();
+            _frameGrid.query(point(int(mousePos.x), int(mousePos.y)), _gridQuery);
+
+            for (const auto frameIndex : _gridQuery) {
+                const auto& frame = frames.at(frameIndex);
+
                 if (frame.frameLocation(fs.grid).contains(mousePos)) {
                     ImGui::ShowTooltip(frame.name);
 
@@ -797,9 +810,28 @@ void SpriteImporterEditorGui::frameEditorGui()
 
     _graphics.drawBackgroundColor(drawList, Style::spriteImporterBackgroundColor);
 
-    _graphics.drawImage(drawList, _imageTexture, 0, 0);
+    _graphics.drawImage(drawList, _imageTexture->texture(), 0, 0);
+
+    // Only process the frames that overlap the visible region and the selected frame.
+    {
+        const point clipMin = _graphics.toPoint(drawList->GetClipRectMin());
+        const point clipMax = _graphics.toPoint(drawList->GetClipRectMax());
+
+        _gridQuery.clear();
+        _frameGrid.query(TwoPointRect(clipMin.x, clipMax.x, clipMin.y, clipMax.y), _gridQuery);
+
+        if (selectedFrame) {
+            const unsigned selectedIndex = _data->framesSel.selectedIndex();
 
-    for (const auto& frame : frames) {
+            auto it = std::lower_bound(_gridQuery.begin(), _gridQuery.end(), selectedIndex);
+            if (it == _gridQuery.end() || *it != selectedIndex) {
+                _gridQuery.insert(it, selectedIndex);
+            }
+        }
+    }
+
+    for (const auto frameIndex : _gridQuery) {
+        const auto& frame = frames.at(frameIndex);
         const auto& aabb = frame.frameLocation(fs.grid);
         const auto& origin = frame.origin(fs.grid);
 
@@ -809,7 +841,8 @@ void SpriteImporterEditorGui::frameEditorGui()
         _graphics.addRect(drawList, &aabb, Style::frameOutlineColor);
     }
 
-    for (auto [frameIndex, frame] : enumerate(frames)) {
+    for (const auto frameIndex : _gridQuery) {
+        auto& frame = frames.at(frameIndex);
         const auto& aabb = frame.frameLocation(fs.grid);
 
         _graphics.setOrigin(aabb.x, aabb.y);
@@ -866,7 +899,13 @@ void SpriteImporterEditorGui::processGui(const Project::ProjectFile& projectFile
     auto& fs = _data->data;
 
     updateImageTexture();
+
+    if (!_exportOrderValid) {
+        // The frame list may have been resized or reordered
+        _frameGridValid = false;
+    }
     updateExportOderTree(fs, projectFile);
+    updateFrameGrid();
 
     splitterSidebarRight(
         "##splitter", &_sidebar,
@@ -909,37 +948,53 @@ void SpriteImporterEditorGui::updateImageTexture()
         return;
     }
 
-    _imageTexture.loadPngImage(fs.imageFilename);
+    _imageTexture = TextureCache::loadPngImage(fs.imageFilename);
 
     _imageValid = true;
     _transparentColorComboValid = false;
 }
 
+void SpriteImporterEditorGui::updateFrameGrid()
+{
+    assert(_data);
+    const auto& fs = _data->data;
+
+    if (_frameGridValid && _frameGrid.nItems() == fs.frames.size()) {
+        return;
+    }
+
+    std::vector<TwoPointRect> rects;
+    rects.reserve(fs.frames.size());
+
+    for (const auto& frame : fs.frames) {
+        rects.emplace_back(frame.frameLocation(fs.grid));
+    }
+
+    _frameGrid.build(rects, FRAME_GRID_CELL_SIZE);
+
+    _frameGridValid = true;
+}
+
 void SpriteImporterEditorGui::updateTransparentColorCombo()
 {
     constexpr static int MAX_COLORS = 32;
 
     assert(_data);
-    auto& fs = _data->data;
 
     if (_transparentColorComboValid) {
         return;
     }
-    const auto& image = ImageCache::loadPngImage(fs.imageFilename);
 
-    _transparentColorCombo.clear();
+    // The histogram is shared with all editors that use the same image
+    const auto& histogram = _imageTexture->colorHistogram();
 
-    std::unordered_set<ImU32> colorSet;
-    for (const auto& pixel : image->data()) {
-        const ImU32 color = pixel.rgbaValue();
+    _transparentColorCombo.clear();
 
-        bool newColor = colorSet.insert(color).second;
-        if (newColor) {
-            _transparentColorCombo.emplace_back(color, pixel.rgbHexString());
+    for (const auto& c : histogram) {
+        _transparentColorCombo.emplace_back(c.color.rgbaValue(), c.color.rgbHexString());
 
-            if (_transparentColorCombo.size() >= MAX_COLORS) {
-                return;
-            }
+        if (_transparentColorCombo.size() >= MAX_COLORS) {
+            break;
         }
     }
 
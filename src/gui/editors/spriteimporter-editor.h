@@ -9,10 +9,11 @@
 #include "abstract-metasprite-editor.hpp"
 #include "gui/abstract-editor.h"
 #include "gui/graphics/aabb-graphics.h"
+#include "gui/graphics/uniform-grid-index.h"
 #include "gui/imgui.h"
 #include "gui/selection.h"
 #include "gui/splitter.h"
-#include "gui/texture.h"
+#include "gui/texture-cache.h"
 #include "models/common/vectorset.h"
 #include "models/project/project.h"
 
@@ -54,7 +55,11 @@ private:
     std::shared_ptr<SpriteImporterEditorData> _data;
 
     AabbGraphics _graphics;
-    Texture _imageTexture;
+    std::shared_ptr<const CachedTexture> _imageTexture;
+
+    // Spatial index of the frame locations (ids are frame indexes).
+    UniformGridIndex _frameGrid;
+    std::vector<unsigned> _gridQuery;
 
     std::vector<std::pair<ImU32, std::u8string>> _transparentColorCombo;
 
@@ -63,6 +68,7 @@ private:
 public:
     bool _imageValid;
     bool _transparentColorComboValid;
+    bool _frameGridValid;
 
 public:
     SpriteImporterEditorGui();
@@ -92,6 +98,7 @@ private:
     void drawSelectedFrame(ImDrawList* drawList, UnTech::MetaSprite::SpriteImporter::Frame* frame);
 
     void updateImageTexture();
+    void updateFrameGrid();
     void updateTransparentColorCombo();
 
     template <auto FieldPtr>
@@ -14,7 +14,9 @@
 #include "models/common/aabb.h"
 #include "models/common/clamp.h"
 #include "models/common/image.h"
+#include "models/common/iterators.h"
 #include "models/common/ms8aabb.h"
+#include <vector>
 
 namespace UnTech::Gui {
 
@@ -44,6 +46,24 @@ private:
         }
     };
 
+    // Entity images are batched and drawn by `drawEntityBatch()`
+    struct EntityQuad {
+        ImVec2 pMin;
+        ImVec2 pMax;
+        ImVec2 uvMin;
+        ImVec2 uvMax;
+        ImU32 tint;
+    };
+
+    // Drawn after the entity images
+    struct EntityHighlight {
+        ImVec2 pMin;
+        ImVec2 pMax;
+        ImU32 fillCol;
+        ImU32 outlineCol;
+        bool selected;
+    };
+
     enum class State {
         DISABLED,
         NONE,
@@ -70,6 +90,9 @@ private:
 private:
     std::vector<SelectedAabb> _selectedAabb;
 
+    std::vector<EntityQuad> _entityQuads;
+    std::vector<EntityHighlight> _entityHighlights;
+
     State _currentState{ State::NONE };
 
     ImVec2 _zoom;
@@ -177,6 +200,8 @@ public:
                    SelectionT*... sel)
     {
         _selectedAabb.clear();
+        _entityQuads.clear();
+        _entityHighlights.clear();
         _lastClickedSelector = nullptr;
         _isHovered = false;
         _previouslySelectedItemClicked = false;
@@ -454,9 +479,9 @@ public:
         addPointRect(drawList, point, color, selected);
     }
 
+    // The entity is not drawn until `drawEntityBatch()` is called.
     template <typename PointT, typename SelectionT>
-    void addEntity(ImDrawList* drawList, PointT* point,
-                   ImTextureID textureId, const DrawEntitySettings& ds,
+    void addEntity(PointT* point, const DrawEntitySettings& ds,
                    const ImU32 fillCol, const ImU32 outlineCol, const ImU32 tintColor,
                    SelectionT* sel, const unsigned index)
     {
@@ -513,19 +538,77 @@ public:
         } break;
         }
 
-        const TwoPointRect ir{
+        batchEntity(point, ds, tintColor);
+
+        if (_isHovered || selected) {
+            _entityHighlights.push_back({ toVec2(r.x1, r.y1), toVec2(r.x2, r.y2), fillCol, outlineCol, selected });
+        }
+    }
+
+    // The entity is not drawn until `drawEntityBatch()` is called.
+    template <typename PointT>
+    inline void batchEntity(const PointT* point, const DrawEntitySettings& ds, const ImU32 tintColor)
+    {
+        if ((tintColor & IM_COL32_A_MASK) == 0) {
+            return;
+        }
+
+        const TwoPointRect r{
             int(point->x) + ds.imageRect.x1,
             int(point->x) + ds.imageRect.x2,
             int(point->y) + ds.imageRect.y1,
             int(point->y) + ds.imageRect.y2
         };
 
-        drawList->AddImage(textureId, toVec2(ir.x1, ir.y1), toVec2(ir.x2, ir.y2),
-                           ds.uvMin, ds.uvMax, tintColor);
+        _entityQuads.push_back({ toVec2(r.x1, r.y1), toVec2(r.x2, r.y2), ds.uvMin, ds.uvMax, tintColor });
+    }
 
-        if (_isHovered || selected) {
-            drawRectFilled(drawList, r, fillCol, outlineCol, selected);
+    // Draws the entities added by `addEntity()` and `batchEntity()`.
+    //
+    // All entity images share `textureId` and are drawn with a single
+    // ImDrawList command (unless there are more than 8192 visible entities).
+    // The hovered and selected entity rectangles are drawn on top of the entity images.
+    void drawEntityBatch(ImDrawList* drawList, ImTextureID textureId)
+    {
+        constexpr size_t QUADS_PER_RESERVE = 8192;
+
+        const ImVec2 clipMin = drawList->GetClipRectMin();
+        const ImVec2 clipMax = drawList->GetClipRectMax();
+
+        std::erase_if(_entityQuads, [&](const EntityQuad& q) {
+            return q.pMax.x < clipMin.x || q.pMin.x > clipMax.x
+                   || q.pMax.y < clipMin.y || q.pMin.y > clipMax.y;
+        });
+
+        if (!_entityQuads.empty()) {
+            drawList->PushTextureID(textureId);
+
+            // Vertices are reserved in blocks to prevent an ImDrawIdx overflow.
+            for (size_t i = 0; i < _entityQuads.size(); i += QUADS_PER_RESERVE) {
+                const size_t n = std::min(QUADS_PER_RESERVE, _entityQuads.size() - i);
+
+                drawList->PrimReserve(int(n * 6), int(n * 4));
+
+                for (const auto j : range(i, i + n)) {
+                    const EntityQuad& q = _entityQuads[j];
+                    drawList->PrimRectUV(q.pMin, q.pMax, q.uvMin, q.uvMax, q.tint);
+                }
+            }
+
+            drawList->PopTextureID();
         }
+
+        for (const auto& h : _entityHighlights) {
+            drawList->AddRectFilled(h.pMin, h.pMax, h.fillCol, 0.0f, ImDrawFlags_RoundCornersNone);
+            drawList->AddRect(h.pMin, h.pMax, h.outlineCol, 0.0f, ImDrawFlags_RoundCornersNone, filledOutlineThickness);
+
+            if (h.selected) {
+                _selectedAabb.emplace_back(h.pMin, h.pMax, h.outlineCol);
+            }
+        }
+
+        _entityQuads.clear();
+        _entityHighlights.clear();
     }
 
     template <typename PointT>
@@ -6,12 +6,15 @@
 
 #include "entity-graphics.h"
 
+#include "models/common/attributes.h"
 #include "models/common/iterators.h"
 #include "models/metasprite/compiler/framesetcompiler.h"
 #include "models/metasprite/drawing.hpp"
+#include "models/project/compiler-status.h"
 #include "models/project/project-data.h"
 #include "models/project/project.h"
 #include "models/snes/convert-snescolor.h"
+#include <algorithm>
 
 namespace UnTech::Gui {
 
@@ -21,8 +24,7 @@ static std::shared_ptr<const EntityGraphics> blankEntityGraphics();
 
 EntityGraphicsStore entityGraphicsStore;
 
-static constexpr unsigned MIN_TEXTURE_WIDTH = 256;
-static constexpr unsigned MIN_TEXTURE_HEIGHT = 64;
+static constexpr unsigned MIN_TEXTURE_SIZE = 64;
 static constexpr unsigned MAX_TEXTURE_SIZE = 1024;
 
 static constexpr int INVALID_FRAME_SIZE = 16;
@@ -100,11 +102,45 @@ struct EntityFrame {
 
     unsigned palette;
 
+    // Used to determine if the frame needs to be redrawn
+    unsigned frameSetIndex;
+    uint64_t frameSetCompileId;
+
     idstring name;
     unsigned entityIndex;
     bool isEntity;
 };
 
+struct FrameImageKey {
+    unsigned frameSetIndex;
+    uint64_t frameSetCompileId;
+    idstring frame;
+    unsigned palette;
+
+    bool operator==(const FrameImageKey&) const = default;
+};
+
+struct FrameImageKeyHash {
+    size_t operator()(const FrameImageKey& key) const
+        __attribute__(IGNORE_UNSIGNED_OVERFLOW_ATTR)
+    {
+        size_t seed = std::hash<idstring>()(key.frame);
+
+        for (const size_t v : { size_t(key.frameSetIndex), size_t(key.frameSetCompileId), size_t(key.palette) }) {
+            // numbers from boost
+            seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+
+        return seed;
+    }
+};
+
+// The entity frames drawn by the previous `processEntityGraphics()` call.
+// A frame is only redrawn when its FrameSet is recompiled.
+//
+// THREAD SAFETY: MUST only be accessed by `processEntityGraphics()` (which is called by the background thread).
+static std::unordered_map<FrameImageKey, std::unique_ptr<const Image>, FrameImageKeyHash> frameImageCache;
+
 struct EntityPackingNode {
     // Input variables
     unsigned entityFrameId; // if UINT_MAX then the id is the missing Image symbol
@@ -117,11 +153,13 @@ struct EntityPackingNode {
     // Output variables
     unsigned x;
     unsigned y;
+    bool placed;
 };
 
 static std::optional<EntityFrame> entityFrame(const Entity::EntityRomEntry& entry,
                                               const MetaSprite::MetaSprite::FrameSet& frameSet,
-                                              std::shared_ptr<const MetaSprite::Compiler::FrameSetData> fsData)
+                                              std::shared_ptr<const MetaSprite::Compiler::FrameSetData> fsData,
+                                              const unsigned frameSetIndex, const uint64_t frameSetCompileId)
 {
     auto frame = frameSet.frames.find(entry.displayFrame);
     if (!frame) {
@@ -137,6 +175,8 @@ static std::optional<EntityFrame> entityFrame(const Entity::EntityRomEntry& entr
         frameSet,
         *frame,
         std::min<unsigned>(entry.defaultPalette, frameSet.palettes.size()),
+        frameSetIndex,
+        frameSetCompileId,
         entry.name,
         0,
         false,
@@ -145,7 +185,8 @@ static std::optional<EntityFrame> entityFrame(const Entity::EntityRomEntry& entr
 
 static std::optional<EntityFrame> findMetaSprite(const Entity::EntityRomEntry& entry,
                                                  const Project::ProjectFile& projectFile,
-                                                 const Project::ProjectData& projectData)
+                                                 const Project::ProjectData& projectData,
+                                                 const Project::CompilerStatus& compilerStatus)
 {
     const auto indexAndData = projectData.frameSets.indexAndDataFor(entry.frameSetId);
 
@@ -156,14 +197,19 @@ static std::optional<EntityFrame> findMetaSprite(const Entity::EntityRomEntry& e
     const auto& frameSetIndex = indexAndData->first;
     const auto& fs = indexAndData->second;
 
+    uint64_t compileId = 0;
+    compilerStatus.readResourceState(ResourceType::FrameSets, frameSetIndex, [&](const auto& rs) {
+        compileId = rs.compileId;
+    });
+
     if (fs->msFrameSet) {
-        return entityFrame(entry, *fs->msFrameSet, fs);
+        return entityFrame(entry, *fs->msFrameSet, fs, frameSetIndex, compileId);
     }
 
     if (frameSetIndex < projectFile.frameSets.size()) {
         const auto& fsf = projectFile.frameSets.at(frameSetIndex);
         if (fsf.msFrameSet) {
-            return entityFrame(entry, *fsf.msFrameSet, nullptr);
+            return entityFrame(entry, *fsf.msFrameSet, nullptr, frameSetIndex, compileId);
         }
     }
 
@@ -171,7 +217,8 @@ static std::optional<EntityFrame> findMetaSprite(const Entity::EntityRomEntry& e
 }
 
 static std::vector<EntityFrame> buildEntityFrameList(const Project::ProjectFile& projectFile,
-                                                     const Project::ProjectData& projectData)
+                                                     const Project::ProjectData& projectData,
+                                                     const Project::CompilerStatus& compilerStatus)
 {
     const auto& erd = projectFile.entityRomData;
 
@@ -181,7 +228,7 @@ static std::vector<EntityFrame> buildEntityFrameList(const Project::ProjectFile&
 
     auto addFrames = [&](const auto& list, const bool isPlayer) {
         for (auto [i, entry] : enumerate(list)) {
-            auto ef = findMetaSprite(entry, projectFile, projectData);
+            auto ef = findMetaSprite(entry, projectFile, projectData, compilerStatus);
 
             if (ef) {
                 ef->isEntity = isPlayer;
@@ -225,56 +272,175 @@ static TwoPointRect frameBounds(const MetaSprite::MetaSprite::Frame& frame)
     return { minX, maxX, minY, maxY };
 }
 
-// An extremely simple row-packing algorithm.
-// Returns height of texture
-static unsigned packFramesGivenWidth(std::vector<EntityPackingNode>& nodes, const unsigned width)
-{
-    constexpr unsigned padding = 1;
+// Skyline bottom-left rectangle packer.
+//
+// The skyline is a list of horizontal segments (sorted by x position) that
+// mark the top of the used space in each column of the texture.
+class SkylinePacker {
+    struct Segment {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+    };
 
-    unsigned xPos = 0;
-    unsigned yPos = 0;
-    unsigned rowHeight = 0;
+    const unsigned _width;
+    const unsigned _height;
+    std::vector<Segment> _skyline;
 
-    for (auto& n : nodes) {
-        if (n.width + xPos > width) {
-            xPos = 0;
-            yPos += rowHeight + padding;
-            rowHeight = 0;
+public:
+    SkylinePacker(const unsigned width, const unsigned height)
+        : _width(width)
+        , _height(height)
+        , _skyline({ Segment{ 0, 0, width } })
+    {
+    }
+
+    // Returns std::nullopt if the rectangle does not fit
+    std::optional<upoint> insert(const unsigned width, const unsigned height)
+    {
+        size_t bestIndex = SIZE_MAX;
+        unsigned bestY = UINT_MAX;
+
+        for (const auto i : range(_skyline.size())) {
+            const unsigned x = _skyline.at(i).x;
+            if (x + width > _width) {
+                break;
+            }
+
+            // The rectangle rests on the highest segment underneath it
+            unsigned y = 0;
+            unsigned remaining = width;
+            for (size_t j = i; remaining > 0; j++) {
+                const Segment& s = _skyline.at(j);
+                y = std::max(y, s.y);
+                remaining -= std::min(remaining, s.width);
+            }
+
+            if (y + height <= _height && y < bestY) {
+                bestIndex = i;
+                bestY = y;
+            }
+        }
+
+        if (bestIndex >= _skyline.size()) {
+            return std::nullopt;
+        }
+
+        const unsigned x = _skyline.at(bestIndex).x;
+        const unsigned right = x + width;
+
+        _skyline.insert(_skyline.begin() + bestIndex, Segment{ x, bestY + height, width });
+
+        // Remove or shrink the segments underneath the new segment
+        const size_t next = bestIndex + 1;
+        while (next < _skyline.size()) {
+            Segment& s = _skyline.at(next);
+            if (s.x >= right) {
+                break;
+            }
+
+            const unsigned sRight = s.x + s.width;
+            if (sRight <= right) {
+                _skyline.erase(_skyline.begin() + next);
+            }
+            else {
+                s.x = right;
+                s.width = sRight - right;
+                break;
+            }
         }
 
-        n.x = xPos;
-        n.y = yPos;
+        // Merge neighbouring segments of the same height
+        size_t i = 0;
+        while (i + 1 < _skyline.size()) {
+            if (_skyline.at(i).y == _skyline.at(i + 1).y) {
+                _skyline.at(i).width += _skyline.at(i + 1).width;
+                _skyline.erase(_skyline.begin() + i + 1);
+            }
+            else {
+                i++;
+            }
+        }
 
-        xPos += n.width + padding;
-        rowHeight = std::max(rowHeight, n.height);
+        return upoint(x, bestY);
     }
+};
 
-    const unsigned height = std::min<unsigned>(yPos + rowHeight, MAX_TEXTURE_SIZE * 4);
+// Returns true if all nodes fit inside the texture
+static bool packFramesGivenSize(std::vector<EntityPackingNode>& nodes, const usize textureSize)
+{
+    constexpr unsigned padding = 1;
+
+    // Padding is not required on the right and bottom edges of the texture
+    SkylinePacker packer(textureSize.width + padding, textureSize.height + padding);
+
+    bool allPlaced = true;
+
+    for (auto& n : nodes) {
+        const auto pos = packer.insert(n.width + padding, n.height + padding);
 
-    unsigned textureHeight = MIN_TEXTURE_HEIGHT;
-    while (textureHeight < height) {
-        textureHeight <<= 1;
+        n.placed = pos.has_value();
+        if (pos) {
+            n.x = pos->x;
+            n.y = pos->y;
+        }
+        else {
+            allPlaced = false;
+        }
     }
-    return textureHeight;
+
+    return allPlaced;
 }
 
+// Packs the nodes into the smallest power-of-two texture that fits them.
+//
+// If the nodes do not fit inside a MAX_TEXTURE_SIZE texture, the nodes that
+// do not fit will have `placed` set to false.
 static usize packFrames(std::vector<EntityPackingNode>& nodes)
 {
-    // This function will only test 3 different texture widths.
-    static_assert(MIN_TEXTURE_WIDTH << (3 - 1) == MAX_TEXTURE_SIZE);
+    unsigned maxWidth = 0;
+    unsigned maxHeight = 0;
+    uint64_t area = 0;
+
+    for (const auto& n : nodes) {
+        maxWidth = std::max(maxWidth, n.width);
+        maxHeight = std::max(maxHeight, n.height);
+        area += uint64_t(n.width + 1) * (n.height + 1);
+    }
 
-    unsigned w = MIN_TEXTURE_WIDTH;
-    unsigned h = 64;
+    std::vector<usize> sizes;
+    for (unsigned w = MIN_TEXTURE_SIZE; w <= MAX_TEXTURE_SIZE; w <<= 1) {
+        for (unsigned h = MIN_TEXTURE_SIZE; h <= MAX_TEXTURE_SIZE; h <<= 1) {
+            if (w >= maxWidth && h >= maxHeight && uint64_t(w) * h >= area) {
+                sizes.emplace_back(w, h);
+            }
+        }
+    }
 
-    while (w <= MAX_TEXTURE_SIZE) {
-        h = packFramesGivenWidth(nodes, w);
+    // Smallest area first, preferring square textures then wide textures
+    std::sort(sizes.begin(), sizes.end(), [](const usize& a, const usize& b) {
+        const unsigned aArea = a.width * a.height;
+        const unsigned bArea = b.width * b.height;
+        if (aArea != bArea) {
+            return aArea < bArea;
+        }
+        const unsigned aLong = std::max(a.width, a.height);
+        const unsigned bLong = std::max(b.width, b.height);
+        if (aLong != bLong) {
+            return aLong < bLong;
+        }
+        return a.width > b.width;
+    });
 
-        if (h <= w) {
-            return usize{ w, h };
+    for (const usize& size : sizes) {
+        if (packFramesGivenSize(nodes, size)) {
+            return size;
         }
-        w <<= 1;
     }
-    return { w, h };
+
+    const usize size(MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE);
+    packFramesGivenSize(nodes, size);
+    return size;
 }
 
 static std::pair<std::vector<EntityPackingNode>, usize>
@@ -314,31 +480,70 @@ packEntityFrames(const std::vector<EntityFrame>& entityFrames)
         assert(it == nodes.end());
     }
 
-    std::sort(nodes.begin(), nodes.end(),
-              [](const auto& a, const auto& b) { return a.height > b.height; });
+    // Invalid entity frame is always placed first
+    std::sort(nodes.begin() + 1, nodes.end(),
+              [](const auto& a, const auto& b) {
+                  if (a.height != b.height) {
+                      return a.height > b.height;
+                  }
+                  return a.width > b.width;
+              });
 
     usize size = packFrames(nodes);
 
     return { nodes, size };
 }
 
+static std::unique_ptr<const Image> drawEntityFrame(const EntityFrame& ef, const EntityPackingNode& node)
+{
+    auto image = std::make_unique<Image>(node.width, node.height);
+    image->fill(rgba());
+
+    std::array<rgba, 16> palette;
+    if (ef.palette < ef.frameSet.palettes.size()) {
+        auto msPalette = ef.frameSet.palettes.at(ef.palette);
+        std::transform(msPalette.begin(), msPalette.end(), palette.begin(),
+                       Snes::toRgb);
+    }
+    else {
+        palette.fill(rgba(255, 0, 0));
+    }
+
+    MS::drawFrame(*image, ef.frameSet, palette, ef.frame,
+                  -node.originX, -node.originY);
+
+    return image;
+}
+
+static void copyImage(Image& image, const Image& source, const unsigned xPos, const unsigned yPos)
+{
+    const usize size = source.size();
+
+    assert(xPos + size.width <= image.size().width);
+    assert(yPos + size.height <= image.size().height);
+
+    for (const auto y : range(size.height)) {
+        const auto sourceBits = source.scanline(y);
+        auto imgBits = image.scanline(yPos + y).subspan(xPos, size.width);
+
+        std::copy(sourceBits.begin(), sourceBits.end(), imgBits.begin());
+    }
+}
+
 void processEntityGraphics(const Project::ProjectFile& projectFile,
                            const Project::ProjectData& projectData,
-                           const uint64_t entityRomDataCompileId)
+                           const Project::CompilerStatus& compilerStatus)
 {
+    const uint64_t entityRomDataCompileId = compilerStatus.getCompileId(ProjectSettingsIndex::EntityRomData);
+
     if (entityRomDataCompileId == entityGraphicsStore.getEntityRomDataCompileId()) {
         return;
     }
 
-    const std::vector<EntityFrame> entityFrames = buildEntityFrameList(projectFile, projectData);
+    const std::vector<EntityFrame> entityFrames = buildEntityFrameList(projectFile, projectData, compilerStatus);
 
     const auto [packingNodes, textureSize] = packEntityFrames(entityFrames);
 
-    if (textureSize.height > MAX_TEXTURE_SIZE) {
-        entityGraphicsStore.set(blankEntityGraphics(), entityRomDataCompileId);
-        return;
-    }
-
     const float uvX = 1.0f / textureSize.width;
     const float uvY = 1.0f / textureSize.height;
 
@@ -351,6 +556,8 @@ void processEntityGraphics(const Project::ProjectFile& projectFile,
         assert(it != packingNodes.end());
 
         const auto& node = *it;
+        assert(node.placed);
+
         DrawEntitySettings& ds = eg->nullSetting;
 
         ds.imageRect.x1 = node.originX;
@@ -369,21 +576,41 @@ void processEntityGraphics(const Project::ProjectFile& projectFile,
     eg->entities.resize(projectFile.entityRomData.entities.size(), eg->nullSetting);
     eg->players.resize(projectFile.entityRomData.players.size(), eg->nullSetting);
 
+    // Frames that are not used by this texture are removed from the cache
+    std::unordered_map<FrameImageKey, std::unique_ptr<const Image>, FrameImageKeyHash> newFrameImageCache;
+
     for (const auto& node : packingNodes) {
         if (node.entityFrameId < entityFrames.size()) {
             const auto& ef = entityFrames.at(node.entityFrameId);
 
-            DrawEntitySettings ds;
+            DrawEntitySettings ds = eg->nullSetting;
 
             ds.name = ef.name;
 
-            ds.imageRect.x1 = node.originX;
-            ds.imageRect.x2 = node.originX + int(node.width);
-            ds.imageRect.y1 = node.originY;
-            ds.imageRect.y2 = node.originY + int(node.height);
-
-            ds.uvMin = ImVec2(node.x * uvX, node.y * uvY);
-            ds.uvMax = ImVec2((node.x + node.width) * uvX, (node.y + node.height) * uvY);
+            if (node.placed) {
+                ds.imageRect.x1 = node.originX;
+                ds.imageRect.x2 = node.originX + int(node.width);
+                ds.imageRect.y1 = node.originY;
+                ds.imageRect.y2 = node.originY + int(node.height);
+
+                ds.uvMin = ImVec2(node.x * uvX, node.y * uvY);
+                ds.uvMax = ImVec2((node.x + node.width) * uvX, (node.y + node.height) * uvY);
+
+                const FrameImageKey key{ ef.frameSetIndex, ef.frameSetCompileId, ef.frame.name, ef.palette };
+
+                auto it = newFrameImageCache.find(key);
+                if (it == newFrameImageCache.end()) {
+                    auto cached = frameImageCache.extract(key);
+                    if (cached) {
+                        it = newFrameImageCache.insert(std::move(cached)).position;
+                    }
+                    else {
+                        it = newFrameImageCache.emplace(key, drawEntityFrame(ef, node)).first;
+                    }
+                }
+
+                copyImage(eg->image, *it->second, node.x, node.y);
+            }
 
             if (ef.frame.tileHitbox.exists) {
                 ds.hitboxRect = TwoPointRect(ef.frame.tileHitbox.aabb);
@@ -392,19 +619,6 @@ void processEntityGraphics(const Project::ProjectFile& projectFile,
                 ds.hitboxRect = NOT_SOLID_HITBOX_RECT;
             }
 
-            std::array<rgba, 16> palette;
-            if (ef.palette < ef.frameSet.palettes.size()) {
-                auto msPalette = ef.frameSet.palettes.at(ef.palette);
-                std::transform(msPalette.begin(), msPalette.end(), palette.begin(),
-                               Snes::toRgb);
-            }
-            else {
-                palette.fill(rgba(255, 0, 0));
-            }
-
-            MS::drawFrame(eg->image, ef.frameSet, palette, ef.frame,
-                          node.x - node.originX, node.y - node.originY);
-
             if (ef.isEntity) {
                 eg->entityNameMap.emplace(ds.name, ef.entityIndex);
                 eg->entities.at(ef.entityIndex) = ds;
@@ -415,6 +629,8 @@ void processEntityGraphics(const Project::ProjectFile& projectFile,
         }
     }
 
+    frameImageCache = std::move(newFrameImageCache);
+
     entityGraphicsStore.set(std::move(eg), entityRomDataCompileId);
 }
 
@@ -17,6 +17,7 @@
 namespace UnTech::Project {
 struct ProjectFile;
 struct ProjectData;
+class CompilerStatus;
 }
 
 namespace UnTech::Gui {
@@ -92,7 +93,8 @@ public:
 
 extern EntityGraphicsStore entityGraphicsStore;
 
+// Only redraws the entity frames whose FrameSet has been recompiled.
 void processEntityGraphics(const Project::ProjectFile& projectFile,
                            const Project::ProjectData& projectData,
-                           const uint64_t entityRomDataCompileId);
+                           const Project::CompilerStatus& compilerStatus);
 }
@@ -0,0 +1,151 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "two-point-rect.h"
+#include "models/common/iterators.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <vector>
+
+namespace UnTech::Gui {
+
+// A uniform grid spatial index of rectangles.
+//
+// Items are identified by their index in the `rects` vector passed to `build()`.
+// Each item is stored in every cell it overlaps, the cells are stored in a
+// single vector (compressed sparse row layout) to reduce allocations.
+//
+// The index does not track changes to the items, it MUST be rebuilt when an
+// item is added, removed or moved.
+class UniformGridIndex {
+private:
+    int _cellSize = 1;
+
+    // Position of the top-left cell (in pixels)
+    int _originX = 0;
+    int _originY = 0;
+
+    int _width = 0;
+    int _height = 0;
+
+    // `_cellItems` indexes for cell `i` are `_cellStart[i]` to `_cellStart[i + 1]`.
+    std::vector<unsigned> _cellStart;
+    std::vector<unsigned> _cellItems;
+
+    unsigned _nItems = 0;
+
+    // Cells are limited to prevent huge grids when items are far apart
+    constexpr static int MAX_CELLS_PER_AXIS = 256;
+
+public:
+    [[nodiscard]] unsigned nItems() const { return _nItems; }
+
+    void clear()
+    {
+        _width = 0;
+        _height = 0;
+        _cellStart.clear();
+        _cellItems.clear();
+        _nItems = 0;
+    }
+
+    void build(const std::vector<TwoPointRect>& rects, const int cellSize)
+    {
+        assert(cellSize > 0);
+
+        clear();
+
+        _nItems = rects.size();
+
+        if (rects.empty()) {
+            return;
+        }
+
+        int x1 = INT_MAX, y1 = INT_MAX;
+        int x2 = INT_MIN, y2 = INT_MIN;
+        for (const auto& r : rects) {
+            x1 = std::min(x1, r.x1);
+            y1 = std::min(y1, r.y1);
+            x2 = std::max(x2, r.x2);
+            y2 = std::max(y2, r.y2);
+        }
+
+        const int size = std::max(x2 - x1, y2 - y1) + 1;
+        _cellSize = std::max(cellSize, (size + MAX_CELLS_PER_AXIS - 1) / MAX_CELLS_PER_AXIS);
+
+        _originX = x1;
+        _originY = y1;
+        _width = (x2 - x1) / _cellSize + 1;
+        _height = (y2 - y1) / _cellSize + 1;
+
+        // Counting sort of the items into the cells
+        _cellStart.assign(size_t(_width * _height) + 1, 0);
+
+        for (const auto& r : rects) {
+            forEachCell(r, [&](const size_t c) { _cellStart.at(c + 1)++; });
+        }
+        for (const auto i : range(1, _cellStart.size())) {
+            _cellStart.at(i) += _cellStart.at(i - 1);
+        }
+
+        _cellItems.resize(_cellStart.back());
+
+        std::vector<unsigned> pos(_cellStart.begin(), _cellStart.end() - 1);
+
+        for (const auto [i, r] : const_enumerate(rects)) {
+            forEachCell(r, [&](const size_t c) { _cellItems.at(pos.at(c)++) = i; });
+        }
+    }
+
+    // Appends the items that overlap `r` (inclusive of the right and bottom edges)
+    // to `out` in ascending order.
+    //
+    // NOTE: The items are tested against the cells, not the items' rectangles.
+    //       The output can contain items that do not overlap `r`.
+    void query(const TwoPointRect& r, std::vector<unsigned>& out) const
+    {
+        const auto start = out.size();
+
+        forEachCell(r, [&](const size_t c) {
+            out.insert(out.end(), _cellItems.begin() + _cellStart.at(c), _cellItems.begin() + _cellStart.at(c + 1));
+        });
+
+        std::sort(out.begin() + start, out.end());
+        out.erase(std::unique(out.begin() + start, out.end()), out.end());
+    }
+
+    void query(const point& p, std::vector<unsigned>& out) const
+    {
+        query(TwoPointRect(p.x, p.x, p.y, p.y), out);
+    }
+
+private:
+    template <typename Function>
+    void forEachCell(const TwoPointRect& r, Function f) const
+    {
+        if (_width <= 0 || _height <= 0) {
+            return;
+        }
+
+        // Coordinates left/above the origin are clamped to the first cell.
+        // The right and bottom edges are inclusive (matches `TwoPointRect::contains()`).
+        const int cx1 = std::clamp((r.x1 - _originX) / _cellSize, 0, _width - 1);
+        const int cx2 = std::clamp((r.x2 - _originX) / _cellSize, 0, _width - 1);
+        const int cy1 = std::clamp((r.y1 - _originY) / _cellSize, 0, _height - 1);
+        const int cy2 = std::clamp((r.y2 - _originY) / _cellSize, 0, _height - 1);
+
+        for (int y = cy1; y <= cy2; y++) {
+            for (int x = cx1; x <= cx2; x++) {
+                f(size_t(y * _width + x));
+            }
+        }
+    }
+};
+
+}
@@ -265,9 +265,39 @@ static int IdstringFilter(ImGuiInputTextCallbackData* data)
     return 1;
 }
 
+// The text is only interned when the item has finished editing.
+// Interning on every keystroke would add every partially typed name to the idstring pool, which is never shrunk.
 bool InputIdstring(const char* label, UnTech::idstring* idstring)
 {
-    return ImGui::InputText(label, &idstring->data, ImGuiInputTextFlags_CallbackCharFilter, &IdstringFilter);
+    // Only one item can be edited at a time
+    static std::u8string editBuffer;
+    static ImGuiID editId = 0;
+
+    const ImGuiID id = GetID(label);
+
+    std::u8string inactiveBuffer;
+    if (editId != id) {
+        inactiveBuffer = idstring->str();
+    }
+    std::u8string& buffer = editId == id ? editBuffer : inactiveBuffer;
+
+    ImGui::InputText(label, &buffer, ImGuiInputTextFlags_CallbackCharFilter, &IdstringFilter);
+
+    if (IsItemActivated()) {
+        editBuffer = buffer;
+        editId = id;
+    }
+
+    const bool edited = IsItemDeactivatedAfterEdit();
+    if (edited) {
+        *idstring = UnTech::idstring::fromString(buffer);
+    }
+
+    if (editId == id && !IsItemActive()) {
+        editId = 0;
+    }
+
+    return edited;
 }
 
 bool InputRgb(const char* label, UnTech::rgba* color, ImGuiColorEditFlags flags)
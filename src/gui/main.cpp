@@ -4,12 +4,14 @@
  * Distributed under The MIT License: https://opensource.org/licenses/MIT
  */
 
+#include "bench-scene.h"
 #include "imgui.h"
 #include "shaders.h"
 #include "untech-editor.h"
 #include "gui/windows/about-popup.h"
 #include "gui/windows/message-box.h"
 #include <iostream>
+#include <optional>
 
 #if defined(IMGUI_IMPL_SDL_OPENGL)
 #include "opengl/imgui_sdl_opengl3.hpp"
@@ -46,6 +48,18 @@ void metricsWindow()
 }
 #endif
 
+static std::optional<UnTech::Gui::BenchScene::Settings> processBenchArguments(const std::span<const char*> arguments)
+{
+    using namespace UnTech::Gui;
+
+    assert(!arguments.empty());
+
+    if (arguments.size() > 1 && std::string_view(arguments[1]) == "--bench-scene") {
+        return BenchScene::parseArguments(arguments);
+    }
+    return std::nullopt;
+}
+
 static void processProgramArguments(const std::span<const char*> arguments)
 {
     using namespace UnTech::Gui;
@@ -55,7 +69,8 @@ static void processProgramArguments(const std::span<const char*> arguments)
     const std::string_view arg = arguments.size() > 1 ? arguments[1] : std::string_view();
 
     if (arguments.size() > 2 || arg == "--help") {
-        std::cout << "Usage " << arguments.front() << " <filename>";
+        std::cout << "Usage " << arguments.front() << " <filename>\n"
+                  << "      " << arguments.front() << BenchScene::usage();
         exit(EXIT_SUCCESS);
     }
     else if (!arg.empty()) {
@@ -67,15 +82,38 @@ static int run_main(std::span<const char*> arguments)
 {
     using namespace UnTech::Gui;
 
+    const auto benchSettings = processBenchArguments(arguments);
+
     ImGuiLoop imgui;
-    imgui.init("UnTech Editor");
+    imgui.init("UnTech Editor", benchSettings.has_value());
 
     ImGuiIO& io = ImGui::GetIO();
     setupGui(io);
 
     Shaders::initialize();
 
-    processProgramArguments(arguments);
+    const auto cleanup = [&] {
+        // Close the project and stop the background thread to prevent a potential use-after-free error on cleanup.
+        UnTechEditor::closeProject();
+
+        Shaders::cleanup();
+        imgui.cleanup();
+    };
+
+    std::optional<BenchScene> bench;
+
+    if (benchSettings) {
+        UnTechEditor::loadProject(benchSettings->projectFilename);
+        if (UnTechEditor::instance() == nullptr) {
+            std::cerr << "Unable to load project\n";
+            cleanup();
+            return EXIT_FAILURE;
+        }
+        bench.emplace(*benchSettings);
+    }
+    else {
+        processProgramArguments(arguments);
+    }
 
     if (UnTechEditor::instance() == nullptr) {
         AboutPopup::openPopup();
@@ -84,6 +122,10 @@ static int run_main(std::span<const char*> arguments)
     while (true) {
         auto editor = UnTechEditor::instance();
 
+        if (bench) {
+            bench->startFrame(*editor);
+        }
+
         Shaders::newFrame();
         imgui.newFrame();
 
@@ -95,12 +137,26 @@ static int run_main(std::span<const char*> arguments)
         MsgBox::processGui();
 
 #ifndef IMGUI_DISABLE_DEBUG_TOOLS
-        metricsWindow();
+        if (!bench) {
+            metricsWindow();
+        }
 #endif
 
         Shaders::processOffscreenRendering();
+
+        if (bench) {
+            bench->guiProcessed();
+        }
+
         imgui.render();
 
+        if (bench) {
+            bench->endFrame();
+            if (bench->finished()) {
+                break;
+            }
+        }
+
         if (editor) {
             editor->updateProjectFile();
 
@@ -119,11 +175,11 @@ static int run_main(std::span<const char*> arguments)
         }
     }
 
-    // Close the project and stop the background thread to prevent a potential use-after-free error on cleanup.
-    UnTechEditor::closeProject();
+    cleanup();
 
-    Shaders::cleanup();
-    imgui.cleanup();
+    if (bench) {
+        bench->printReport(std::cout);
+    }
 
     return EXIT_SUCCESS;
 }
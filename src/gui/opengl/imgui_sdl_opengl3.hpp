@@ -30,8 +30,14 @@ public:
     const ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
 public:
-    inline void init(const char* window_title)
+    // If `headless` is true the SDL offscreen video driver is used (unless
+    // `SDL_VIDEODRIVER` is set) and vsync is disabled.
+    inline void init(const char* window_title, const bool headless = false)
     {
+        if (headless) {
+            SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+        }
+
         // Setup SDL
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_GAMECONTROLLER) != 0) {
             printf("Error: %s\n", SDL_GetError());
@@ -70,7 +76,7 @@ public:
         window = SDL_CreateWindow(window_title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720, window_flags);
         gl_context = SDL_GL_CreateContext(window);
         SDL_GL_MakeCurrent(window, gl_context);
-        SDL_GL_SetSwapInterval(1); // Enable vsync
+        SDL_GL_SetSwapInterval(headless ? 0 : 1); // Enable vsync (disabled when headless so benchmarks are not frame-rate limited)
 
         // Setup OpenGL Loader
         if (gl3wInit() != GL3W_OK) {
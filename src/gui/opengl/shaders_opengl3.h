@@ -250,6 +250,52 @@ public:
     void addToDrawList(ImDrawList* drawList, const ImVec2& pos, const ImVec2& size, const MtTileset& tileset) const;
 };
 
+// A tileset that is stored on the GPU as palette indexes.
+//
+// The RGBA `texture()` is drawn by `processOffscreenRendering()`, a palette
+// change or tile edit does not require the whole tileset to be redrawn and
+// uploaded.  Color 0 is transparent.
+//
+// NOTE: This class is NOT thread safe.
+struct PalettedTileset {
+public:
+    constexpr static unsigned N_COLORS = 16;
+
+private:
+    Texture8 _indexes;
+    Texture _palette;
+    Texture _texture;
+
+    GLuint _frameBuffer = 0;
+
+    bool _textureValid;
+
+public:
+    PalettedTileset(const PalettedTileset&) = delete;
+    PalettedTileset(PalettedTileset&&) = delete;
+    PalettedTileset& operator=(const PalettedTileset&) = delete;
+    PalettedTileset& operator=(PalettedTileset&&) = delete;
+
+public:
+    PalettedTileset();
+    ~PalettedTileset();
+
+    // Must only be called by `processOffscreenRendering()`
+    void drawTexture_openGL();
+
+    const Texture& texture() const { return _texture; }
+
+    // Replaces the palette indexes and resizes the tileset
+    void setIndexes(const grid<uint8_t>& indexes);
+
+    // Replaces a `size` rectangle of palette indexes at `x`, `y`.
+    void setIndexes(unsigned x, unsigned y, const usize& size, const uint8_t* indexes);
+
+    // `colors` MUST contain N_COLORS colors.
+    // An empty `colors` will hide the tileset.
+    void setPalette(std::span<const rgba> colors);
+};
+
 void initialize();
 void cleanup();
 
@@ -19,6 +19,7 @@ namespace UnTech::Gui::Shaders {
 static bool g_initialized = false;
 
 static std::vector<MtTileset*> mtTilesetInstances;
+static std::vector<PalettedTileset*> palettedTilesetInstances;
 
 static void CheckShader(GLuint handle, const char* name)
 {
@@ -229,6 +230,87 @@ static void draw(const Texture8& image, const Texture& palette, unsigned palette
 
 }
 
+namespace PalettedTilesetShader {
+
+const GLchar* fragment_shader = R"glsl(
+#version 130
+
+uniform usampler2D Texture;
+uniform sampler2D Palette;
+
+in vec2 Frag_UV;
+
+void main()
+{
+    int c = int(texture(Texture, Frag_UV.st).x) & 0xf;
+
+    if (c != 0) {
+        gl_FragColor = texelFetch(Palette, ivec2(c, 0), 0);
+    }
+    else {
+        gl_FragColor = vec4(0.0, 0.0, 0.0, 0.0);
+    }
+}
+)glsl";
+
+static GLuint g_shaderHandle = 0;
+static GLint g_uniformTexture = 0;
+static GLint g_uniformPalette = 0;
+static GLint g_attribPosition = 0;
+static GLint g_attribUV = 0;
+
+static void initialize()
+{
+    if (g_initialized) {
+        return;
+    }
+
+    GLuint fragHandle = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragHandle, 1, &fragment_shader, 0);
+    glCompileShader(fragHandle);
+    CheckShader(fragHandle, "Paletted Tileset fragment shader");
+
+    g_shaderHandle = glCreateProgram();
+    glAttachShader(g_shaderHandle, MtTilesetVertexShader::g_vertexHangle);
+    glAttachShader(g_shaderHandle, fragHandle);
+    glLinkProgram(g_shaderHandle);
+    CheckProgram(g_shaderHandle, "Paletted Tileset shader program");
+
+    g_uniformTexture = glGetUniformLocation(g_shaderHandle, "Texture");
+    g_uniformPalette = glGetUniformLocation(g_shaderHandle, "Palette");
+
+    g_attribPosition = glGetAttribLocation(g_shaderHandle, "Position");
+    g_attribUV = glGetAttribLocation(g_shaderHandle, "UV");
+
+    glDeleteShader(fragHandle);
+}
+
+static void cleanup()
+{
+    if (g_shaderHandle) {
+        glDeleteProgram(g_shaderHandle);
+        g_shaderHandle = 0;
+    }
+}
+
+static void draw(const Texture8& indexes, const Texture& palette)
+{
+    glUseProgram(g_shaderHandle);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, indexes.openGLTextureId());
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, palette.openGLTextureId());
+
+    glUniform1i(g_uniformTexture, 1);
+    glUniform1i(g_uniformPalette, 0);
+
+    MtTilesetVertexShader::draw(g_attribPosition, g_attribUV);
+}
+
+}
+
 namespace InteractiveTiles {
 
 const GLchar* tc_fragment_shader = R"glsl(
@@ -526,6 +608,7 @@ void initialize()
 
     MtTilesetVertexShader::initialize();
     MtTilesetTilesShader::initialize();
+    PalettedTilesetShader::initialize();
     InteractiveTiles::initialize();
     TileCollisions::initialize();
     Tilemap::initialize();
@@ -535,11 +618,13 @@ void initialize()
 
 void cleanup()
 {
-    // all MtTileset instances should be destroyed before calling cleanup().
+    // all MtTileset and PalettedTileset instances should be destroyed before calling cleanup().
     assert(mtTilesetInstances.empty());
+    assert(palettedTilesetInstances.empty());
 
     MtTilesetVertexShader::cleanup();
     MtTilesetTilesShader::cleanup();
+    PalettedTilesetShader::cleanup();
     InteractiveTiles::cleanup();
     TileCollisions::cleanup();
     Tilemap::cleanup();
@@ -815,6 +900,90 @@ void MtTilemap::addToDrawList(ImDrawList* drawList, const ImVec2& pos, const ImV
     drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
 }
 
+PalettedTileset::PalettedTileset()
+    : _indexes()
+    , _palette(N_COLORS, 1)
+    , _texture()
+    , _frameBuffer(0)
+    , _textureValid(true)
+{
+    // Add to list of PalettedTileset instances
+    palettedTilesetInstances.push_back(this);
+
+    glGenFramebuffers(1, &_frameBuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _frameBuffer);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           _texture.openGLTextureId(), 0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+PalettedTileset::~PalettedTileset()
+{
+    // Remove from list of PalettedTileset instances
+    auto it = std::find(palettedTilesetInstances.begin(), palettedTilesetInstances.end(), this);
+    assert(it != palettedTilesetInstances.end());
+    palettedTilesetInstances.erase(it);
+
+    glDeleteFramebuffers(1, &_frameBuffer);
+}
+
+void PalettedTileset::setIndexes(const grid<uint8_t>& indexes)
+{
+    _indexes.setData(indexes);
+    _texture.resize(indexes.size());
+
+    _textureValid = false;
+}
+
+void PalettedTileset::setIndexes(const unsigned x, const unsigned y, const usize& size, const uint8_t* indexes)
+{
+    _indexes.setSubData(x, y, size, indexes);
+
+    _textureValid = false;
+}
+
+void PalettedTileset::setPalette(const std::span<const rgba> colors)
+{
+    assert(colors.empty() || colors.size() == N_COLORS);
+
+    // A blank image is fully transparent
+    Image image(N_COLORS, 1);
+    std::copy_n(colors.begin(), std::min<size_t>(colors.size(), N_COLORS), image.data().begin());
+
+    _palette.replace(image);
+
+    _textureValid = false;
+}
+
+inline void PalettedTileset::drawTexture_openGL()
+{
+    if (_textureValid) {
+        return;
+    }
+
+    if (_texture.width() > 0 && _texture.height() > 0) {
+        glDisable(GL_SCISSOR_TEST);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+
+        glDepthMask(GL_FALSE);
+
+        glViewport(0, 0, _texture.width(), _texture.height());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _frameBuffer);
+
+        PalettedTilesetShader::draw(_indexes, _palette);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    _textureValid = true;
+}
+
 void newFrame()
 {
     Tilemap::renderDataCount = 0;
@@ -825,6 +994,10 @@ void processOffscreenRendering()
     for (auto* mt : mtTilesetInstances) {
         mt->drawTextures_openGL();
     }
+
+    for (auto* pt : palettedTilesetInstances) {
+        pt->drawTexture_openGL();
+    }
 }
 
 }
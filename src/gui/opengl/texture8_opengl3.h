@@ -100,6 +100,22 @@ public:
     {
         setData(data.size(), data.gridData().data());
     }
+
+    // Replaces a `size` rectangle of the texture at `x`, `y`.
+    // The rectangle MUST be inside the texture.
+    void setSubData(const unsigned x, const unsigned y, const usize& size, const uint8_t* data)
+    {
+        assert(_textureId != 0);
+        assert(x + size.width <= _size.width && y + size.height <= _size.height);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        glBindTexture(GL_TEXTURE_2D, _textureId);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, size.width, size.height,
+                        GL_RED_INTEGER, GL_UNSIGNED_BYTE, data);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
 };
 
 }
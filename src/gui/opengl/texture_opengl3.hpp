@@ -91,7 +91,19 @@ public:
         }
     }
 
-    void loadPngImage(const std::filesystem::path& filename);
+    // The contents of the texture are undefined after a resize.
+    void resize(const usize& size)
+    {
+        assert(_textureId != 0);
+
+        if (size != _size) {
+            _size = size;
+
+            glBindTexture(GL_TEXTURE_2D, _textureId);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _size.width, _size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
     void replaceWithMissingImageSymbol();
 };
 
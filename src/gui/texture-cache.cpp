@@ -0,0 +1,94 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "texture-cache.h"
+#include "models/common/imagecache.h"
+#include <cassert>
+#include <unordered_map>
+
+namespace UnTech::Gui {
+
+static std::vector<ColorCount> buildColorHistogram(const Image& image)
+{
+    std::vector<ColorCount> histogram;
+    std::unordered_map<uint32_t, size_t> colorIndexes;
+
+    // Sprite sheets contain long runs of the same color,
+    // the previous pixel is tested before searching the map.
+    size_t prevIndex = 0;
+    uint32_t prevColor = 0;
+
+    for (const rgba& pixel : image.data()) {
+        const uint32_t color = pixel.rgbaValue();
+
+        if (!histogram.empty() && color == prevColor) {
+            histogram[prevIndex].count++;
+            continue;
+        }
+
+        auto [it, inserted] = colorIndexes.try_emplace(color, histogram.size());
+        if (inserted) {
+            histogram.push_back({ pixel, 0 });
+        }
+
+        prevIndex = it->second;
+        prevColor = color;
+
+        histogram[prevIndex].count++;
+    }
+
+    return histogram;
+}
+
+CachedTexture::CachedTexture(std::shared_ptr<const Image> image)
+    : _image(std::move(image))
+    , _texture()
+    , _colorHistogram()
+{
+    assert(_image);
+
+    if (!_image->empty()) {
+        _texture.replace(*_image);
+    }
+    else {
+        _texture.replaceWithMissingImageSymbol();
+    }
+}
+
+const std::vector<ColorCount>& CachedTexture::colorHistogram() const
+{
+    if (!_colorHistogram) {
+        _colorHistogram = buildColorHistogram(*_image);
+    }
+    return *_colorHistogram;
+}
+
+std::shared_ptr<const CachedTexture> TextureCache::loadPngImage(const std::filesystem::path& filename)
+{
+    // The key is the address of the ImageCache image.
+    // An alive CachedTexture holds a reference to the image, preventing the address from being reused.
+    static std::unordered_map<const Image*, std::weak_ptr<const CachedTexture>> cache;
+
+    std::shared_ptr<const Image> image = ImageCache::loadPngImage(filename);
+    assert(image);
+
+    const auto it = cache.find(image.get());
+    if (it != cache.end()) {
+        if (auto texture = it->second.lock()) {
+            return texture;
+        }
+    }
+
+    // Remove expired textures
+    std::erase_if(cache, [](const auto& e) { return e.second.expired(); });
+
+    auto texture = std::make_shared<const CachedTexture>(std::move(image));
+    cache.emplace(&texture->image(), texture);
+
+    return texture;
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "texture.h"
+#include "models/common/image.h"
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace UnTech::Gui {
+
+struct ColorCount {
+    rgba color;
+    unsigned count;
+};
+
+// A GPU texture of an `ImageCache` image.
+//
+// NOTE: This class is NOT thread safe.
+class CachedTexture {
+private:
+    const std::shared_ptr<const Image> _image;
+    Texture _texture;
+
+    mutable std::optional<std::vector<ColorCount>> _colorHistogram;
+
+public:
+    CachedTexture(const CachedTexture&) = delete;
+    CachedTexture(CachedTexture&&) = delete;
+    CachedTexture& operator=(const CachedTexture&) = delete;
+    CachedTexture& operator=(CachedTexture&&) = delete;
+
+public:
+    explicit CachedTexture(std::shared_ptr<const Image> image);
+    ~CachedTexture() = default;
+
+    const Image& image() const { return *_image; }
+    const Texture& texture() const { return _texture; }
+
+    // The distinct colors of the image (in the order they first appear in the image).
+    // Calculated on the first call.
+    const std::vector<ColorCount>& colorHistogram() const;
+};
+
+/**
+ * The TextureCache shares the textures of `ImageCache` images between the
+ * editors, preventing the image from being uploaded to the GPU multiple times.
+ *
+ * The texture is deleted when the last `CachedTexture` reference is released.
+ *
+ * A new texture is created if the image is invalidated in the `ImageCache`.
+ *
+ * NOTE: The TextureCache is NOT thread safe and MUST only be accessed by the GUI thread.
+ */
+class TextureCache {
+public:
+    TextureCache() = delete;
+
+public:
+    // Will never return a nullptr
+    // If the image cannot be loaded, the texture will contain the missing image symbol.
+    static std::shared_ptr<const CachedTexture> loadPngImage(const std::filesystem::path& filename);
+};
+
+}
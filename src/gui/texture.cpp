@@ -6,7 +6,6 @@
 
 #include "texture.h"
 #include "models/common/image.h"
-#include "models/common/imagecache.h"
 #include "models/common/iterators.h"
 
 namespace UnTech::Gui {
@@ -39,17 +38,4 @@ void Texture::replaceWithMissingImageSymbol()
     replace(*symbol);
 }
 
-void Texture::loadPngImage(const std::filesystem::path& filename)
-{
-    auto image = ImageCache::loadPngImage(filename);
-    assert(image);
-
-    if (!image->empty()) {
-        this->replace(*image);
-    }
-    else {
-        this->replaceWithMissingImageSymbol();
-    }
-}
-
 }
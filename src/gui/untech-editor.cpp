@@ -30,6 +30,7 @@ UnTechEditor::UnTechEditor(std::unique_ptr<UnTech::Project::ProjectFile> pf, con
     , _currentEditorGui(nullptr)
     , _lastCompileId(UINT64_MAX)
     , _projectListWindow()
+    , _compileTimingsWindow()
     , _projectListSidebar{ 280, 150, 500 }
     , _showProjectListSidebar(true)
     , _openUnsavedChangesOnExitPopup(false)
@@ -155,6 +156,8 @@ void UnTechEditor::openEditor(const ItemIndex itemIndex)
                 _currentEditorGui->undoClicked = false;
 
                 _currentEditorGui->resetState();
+
+                _backgroundThread.setPriorityResource(_currentEditor->itemIndex());
             }
             else {
                 _currentEditor = nullptr;
@@ -179,6 +182,8 @@ void UnTechEditor::closeEditor()
     _currentEditor = nullptr;
     _currentEditorGui = nullptr;
 
+    _backgroundThread.setPriorityResource(std::nullopt);
+
     // Ensure `AbstractEditorGui::resourceCompiled` is called on the next frame.
     _lastCompileId = UINT64_MAX;
 }
@@ -368,6 +373,7 @@ void UnTechEditor::processMenu()
         }
 
         ImGui::MenuItem("Project List Sidebar", "`", &_showProjectListSidebar);
+        ImGui::MenuItem("Compile Timings", nullptr, &_compileTimingsWindow.open);
 
         ImGui::Separator();
 
@@ -575,10 +581,10 @@ void UnTechEditor::processGui()
             [&](const auto& rs) {
                 if (rs.compileId != _lastCompileId) {
                     _lastCompileId = rs.compileId;
-                    _currentEditorGui->resourceCompiled(rs.errorList);
+                    _currentEditorGui->resourceCompiled(*rs.errorList);
                 }
 
-                processErrorListWindow(_currentEditor.get(), rs.state, rs.errorList);
+                processErrorListWindow(_currentEditor.get(), rs.state, *rs.errorList);
             });
 
         _backgroundThread.read_pf([&](const auto& pf) {
@@ -586,6 +592,8 @@ void UnTechEditor::processGui()
         });
     }
 
+    _compileTimingsWindow.processGui(_backgroundThread.compilerStatus());
+
     processMenu();
     processKeyboardShortcuts();
     unsavedChangesOnExitPopup();
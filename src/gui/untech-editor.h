@@ -10,6 +10,7 @@
 #include "item-index.h"
 #include "splitter.h"
 #include "models/project/project.h"
+#include "windows/compile-timings-window.h"
 #include "windows/projectlist.h"
 #include <filesystem>
 #include <memory>
@@ -41,6 +42,7 @@ private:
     uint64_t _lastCompileId;
 
     ProjectListWindow _projectListWindow;
+    CompileTimingsWindow _compileTimingsWindow;
 
     SplitterBarState _projectListSidebar;
 
@@ -72,8 +74,11 @@ public:
     // called after ImGUI render
     void updateProjectFile();
 
-private:
+    const auto& compilerStatus() const { return _backgroundThread.compilerStatus(); }
+
     void openEditor(const ItemIndex itemIndex);
+
+private:
     void closeEditor();
 
     // Will block execution if background thread is reading ProjectFile
@@ -0,0 +1,180 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "compile-timings-window.h"
+#include "gui/imgui.h"
+#include "gui/style.h"
+#include "models/common/iterators.h"
+#include <algorithm>
+#include <charconv>
+
+namespace UnTech::Gui {
+
+using RS = Project::ResourceState;
+
+static const char8_t* stateString(const RS state)
+{
+    switch (state) {
+    case RS::AllUnchecked:
+    case RS::Unchecked:
+        return u8"Unchecked";
+
+    case RS::Valid:
+        return u8"Valid";
+
+    case RS::Invalid:
+        return u8"Invalid";
+
+    case RS::Missing:
+        return u8"Missing";
+
+    case RS::DependencyError:
+        return u8"Dependency Error";
+    }
+
+    return u8"";
+}
+
+void CompileTimingsWindow::updateRows(const Project::CompilerStatus& status)
+{
+    using namespace std::chrono;
+
+    auto snapshot = status.snapshot();
+    if (_snapshot && snapshot->statusId == _snapshot->statusId) {
+        return;
+    }
+    _snapshot = std::move(snapshot);
+
+    _rows.clear();
+
+    for (const auto [typeIndex, list] : const_enumerate(_snapshot->lists)) {
+        for (const auto& rs : list->resources) {
+            _rows.push_back({
+                .type = ResourceType(typeIndex),
+                .typeName = &list->typeNameSingle,
+                .name = rs->name,
+                .state = rs->state,
+                .compileTime = rs->compileTime,
+                .timeString = {},
+                .timeStringSize = 0,
+            });
+        }
+    }
+
+    _totalTimeMs = 0;
+
+    for (auto& r : _rows) {
+        const double ms = duration<double, std::milli>(r.compileTime).count();
+        _totalTimeMs += ms;
+
+        const auto result = std::to_chars(r.timeString.data(), r.timeString.data() + r.timeString.size(),
+                                          ms, std::chars_format::fixed, 3);
+        r.timeStringSize = result.ptr - r.timeString.data();
+    }
+
+    sortRows();
+}
+
+void CompileTimingsWindow::sortRows()
+{
+    auto sortBy = [&](auto key) {
+        if (_sortAscending) {
+            std::stable_sort(_rows.begin(), _rows.end(), [&](const Row& a, const Row& b) { return key(a) < key(b); });
+        }
+        else {
+            std::stable_sort(_rows.begin(), _rows.end(), [&](const Row& a, const Row& b) { return key(b) < key(a); });
+        }
+    };
+
+    switch (_sortColumn) {
+    case 0:
+        sortBy([](const Row& r) { return unsigned(r.type); });
+        break;
+
+    case 1:
+        sortBy([](const Row& r) -> const std::u8string& { return r.name; });
+        break;
+
+    case 2:
+        sortBy([](const Row& r) { return unsigned(r.state); });
+        break;
+
+    default:
+        sortBy([](const Row& r) { return r.compileTime; });
+        break;
+    }
+}
+
+void CompileTimingsWindow::processGui(const Project::CompilerStatus& status)
+{
+    if (!open) {
+        return;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Compile Timings", &open)) {
+        updateRows(status);
+
+        ImGui::Text("Total: %0.2f ms", _totalTimeMs);
+
+        constexpr auto tableFlags = ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg
+                                    | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY;
+
+        if (ImGui::BeginTable("Timings", 4, tableFlags)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Type");
+            ImGui::TableSetupColumn("Name");
+            ImGui::TableSetupColumn("State");
+            ImGui::TableSetupColumn("Time (ms)", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+            ImGui::TableHeadersRow();
+
+            if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs()) {
+                if (sortSpecs->SpecsDirty && sortSpecs->SpecsCount > 0) {
+                    _sortColumn = sortSpecs->Specs[0].ColumnIndex;
+                    _sortAscending = sortSpecs->Specs[0].SortDirection == ImGuiSortDirection_Ascending;
+                    sortSpecs->SpecsDirty = false;
+
+                    sortRows();
+                }
+            }
+
+            ImGuiListClipper clipper;
+            clipper.Begin(_rows.size());
+
+            while (clipper.Step()) {
+                for (const auto i : irange(clipper.DisplayStart, clipper.DisplayEnd)) {
+                    const Row& r = _rows.at(i);
+
+                    ImGui::TableNextRow();
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(*r.typeName);
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(r.name);
+
+                    ImGui::TableNextColumn();
+                    if (r.state != RS::Valid) {
+                        ImGui::PushStyleColor(ImGuiCol_Text, Style::failColor);
+                        ImGui::TextUnformatted(stateString(r.state));
+                        ImGui::PopStyleColor();
+                    }
+                    else {
+                        ImGui::TextUnformatted(stateString(r.state));
+                    }
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(r.timeString.data(), r.timeString.data() + r.timeStringSize);
+                }
+            }
+
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+
+}
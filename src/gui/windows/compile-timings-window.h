@@ -0,0 +1,57 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "models/enums.h"
+#include "models/project/compiler-status.h"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace UnTech::Gui {
+
+// Displays the time taken to compile each resource
+class CompileTimingsWindow {
+    struct Row {
+        ResourceType type;
+        const std::u8string* typeName;
+        std::u8string name;
+        Project::ResourceState state;
+        std::chrono::steady_clock::duration compileTime;
+
+        // Formatted compile time (in milliseconds)
+        std::array<char, 24> timeString;
+        unsigned timeStringSize;
+    };
+
+private:
+    std::vector<Row> _rows;
+    double _totalTimeMs = 0;
+
+    // The rows are only rebuilt when the CompilerStatus changes.
+    // Also keeps `Row::typeName` alive.
+    std::shared_ptr<const Project::CompilerStatus::Snapshot> _snapshot;
+
+    // Sorted column, `ImGuiTableSortSpecs` is only valid for the current frame
+    int _sortColumn = 3;
+    bool _sortAscending = false;
+
+public:
+    bool open = false;
+
+    CompileTimingsWindow() = default;
+
+    void processGui(const Project::CompilerStatus& status);
+
+private:
+    void updateRows(const Project::CompilerStatus& status);
+    void sortRows();
+};
+
+}
@@ -8,6 +8,7 @@
 #include "gui/abstract-editor.h"
 #include "gui/imgui.h"
 #include "gui/style.h"
+#include "models/common/iterators.h"
 
 namespace UnTech::Gui {
 
@@ -31,23 +32,33 @@ void processErrorListWindow(gsl::not_null<AbstractEditorData*> editorData, const
             ImGui::TextUnformatted(u8"Dependency Error");
         }
 
-        for (const auto& item : errors.list()) {
-            if (!item->isWarning) {
-                ImGui::PushStyleColor(ImGuiCol_Text, Style::failColor);
-            }
-            else {
-                ImGui::PushStyleColor(ImGuiCol_Text, Style::warningColor);
-            }
+        const auto& list = errors.list();
 
-            ImGui::Bullet();
-            ImGui::PopStyleColor();
+        // An image can contain tens of thousands of errors, only the visible errors are processed.
+        ImGuiListClipper clipper;
+        clipper.Begin(list.size());
 
-            ImGui::SameLine();
-            ImGui::TextUnformatted(item->message);
+        while (clipper.Step()) {
+            for (const auto i : irange(clipper.DisplayStart, clipper.DisplayEnd)) {
+                const auto& item = list.at(i);
+
+                if (!item->isWarning) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, Style::failColor);
+                }
+                else {
+                    ImGui::PushStyleColor(ImGuiCol_Text, Style::warningColor);
+                }
+
+                ImGui::Bullet();
+                ImGui::PopStyleColor();
+
+                ImGui::SameLine();
+                ImGui::TextUnformatted(item->message);
 
-            if (ImGui::IsItemClicked()) {
-                if (ImGui::IsMouseDoubleClicked(0)) {
-                    editorData->errorDoubleClicked(item.get());
+                if (ImGui::IsItemClicked()) {
+                    if (ImGui::IsMouseDoubleClicked(0)) {
+                        editorData->errorDoubleClicked(item.get());
+                    }
                 }
             }
         }
@@ -212,22 +212,28 @@ void ProjectListWindow::projectListWindow(const UnTech::Project::CompilerStatus&
 
     std::optional<ItemIndex> pendingIndex = _selectedIndex;
 
-    status.resourceLists().read([&](const auto& resourceLists) {
-        for (const auto [rtIndex, rList] : enumerate(resourceLists)) {
+    const auto snapshot = status.snapshot();
 
-            assert(resourceLists.size() == N_RESOURCE_TYPES);
-            const auto type = static_cast<ResourceType>(rtIndex);
+    for (const auto [rtIndex, rListPtr] : const_enumerate(snapshot->lists)) {
+        const auto& rList = *rListPtr;
+        const auto type = static_cast<ResourceType>(rtIndex);
 
-            assert(rList.resources.size() < INT_MAX);
+        assert(rList.resources.size() < INT_MAX);
 
-            resourceStateIcon(rList.state);
-            ImGui::SameLine();
-            ImGui::TextUnformatted(rList.typeNamePlural);
+        resourceStateIcon(rList.state);
+        ImGui::SameLine();
+        ImGui::TextUnformatted(rList.typeNamePlural);
+
+        ImGui::PushID(int(type));
+        ImGui::Indent();
 
-            ImGui::PushID(int(type));
-            ImGui::Indent();
+        // Only the visible resources are processed
+        ImGuiListClipper clipper;
+        clipper.Begin(rList.resources.size());
 
-            for (auto [index, item] : enumerate(rList.resources)) {
+        while (clipper.Step()) {
+            for (const auto index : irange(clipper.DisplayStart, clipper.DisplayEnd)) {
+                const auto& item = *rList.resources.at(index);
                 const ItemIndex itemIndex{ type, unsigned(index) };
 
                 ImGui::PushID(index);
@@ -250,11 +256,11 @@ void ProjectListWindow::projectListWindow(const UnTech::Project::CompilerStatus&
 
                 ImGui::PopID();
             }
-
-            ImGui::Unindent();
-            ImGui::PopID();
         }
-    });
+
+        ImGui::Unindent();
+        ImGui::PopID();
+    }
 
     _selectedIndex = pendingIndex;
 
@@ -0,0 +1,21 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include <memory_resource>
+
+namespace UnTech {
+
+// Memory arena for the temporary data of a single compile or conversion.
+//
+// Temporary data (tile maps, name indexes, intermediate tilesets) is
+// allocated from the arena and freed in one go when the arena is destroyed.
+//
+// Output data outlives the arena and MUST use the default allocator.
+using CompilerArena = std::pmr::monotonic_buffer_resource;
+
+}
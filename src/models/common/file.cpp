@@ -158,4 +158,54 @@ void writeFile(const std::filesystem::path& filePath, const std::u8string_view d
     writeFile(filePath, std::as_bytes(std::span{ data }));
 }
 
+static bool fileContentsEqual(const std::filesystem::path& filePath, std::span<const std::byte> data)
+{
+    std::error_code ec;
+
+    const auto size = std::filesystem::file_size(filePath, ec);
+    if (ec || size != data.size()) {
+        return false;
+    }
+
+    std::ifstream in(filePath, std::ios::in | std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    std::array<char, 16 * 1024> buffer{};
+    auto dataIt = data.begin();
+
+    while (dataIt != data.end()) {
+        const auto toRead = std::min<size_t>(buffer.size(), std::distance(dataIt, data.end()));
+
+        in.read(buffer.data(), toRead);
+        if (in.gcount() != std::streamsize(toRead)) {
+            return false;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!std::equal(buffer.begin(), buffer.begin() + toRead, reinterpret_cast<const char*>(&*dataIt))) {
+            return false;
+        }
+        dataIt += toRead;
+    }
+
+    return true;
+}
+
+bool writeFileIfChanged(const std::filesystem::path& filePath, std::span<const std::byte> data)
+{
+    if (fileContentsEqual(filePath, data)) {
+        return false;
+    }
+
+    writeFile(filePath, data);
+    return true;
+}
+
+bool writeFileIfChanged(const std::filesystem::path& filePath, const std::vector<uint8_t>& data)
+{
+    return writeFileIfChanged(filePath, std::as_bytes(std::span{ data }));
+}
+
 }
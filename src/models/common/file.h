@@ -44,4 +44,18 @@ void writeFile(const std::filesystem::path& filePath, const std::vector<uint8_t>
 void writeFile(const std::filesystem::path& filePath, const std::u8string& data);
 void writeFile(const std::filesystem::path& filePath, const std::u8string_view data);
 
+/**
+ * Writes `data` to a file on disk if the file does not exist or if its
+ * contents differ from `data`.
+ *
+ * Leaving unchanged files untouched preserves their modification time, which
+ * prevents build systems from needlessly rebuilding files that depend on them.
+ *
+ * Returns true if the file was written.
+ *
+ * Will raise an exception if an error occurred.
+ */
+bool writeFileIfChanged(const std::filesystem::path& filePath, std::span<const std::byte> data);
+bool writeFileIfChanged(const std::filesystem::path& filePath, const std::vector<uint8_t>& data);
+
 }
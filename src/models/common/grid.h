@@ -10,6 +10,7 @@
 #include "exceptions.h"
 #include "stringbuilder.h"
 #include "models/common/iterators.h"
+#include <algorithm>
 #include <cassert>
 #include <span>
 #include <vector>
@@ -170,6 +171,53 @@ public:
         return subGrid(r.x, r.y, r.width, r.height);
     }
 
+    // Copies columns `x` to `x + nColumns - 1` to `out` in column-major order.
+    //
+    // Column `x + i` is written to `out[i * stride]` to `out[i * stride + height - 1]`.
+    // Cells between the end of a column and the start of the next column are unchanged.
+    //
+    // The copy is performed in blocks to minimise the cache misses of the strided reads.
+    void transposeInto(std::span<T> out, const size_t stride, const unsigned x, const unsigned nColumns) const
+    {
+        constexpr unsigned BLOCK_SIZE = 16;
+
+        if (nColumns == 0) {
+            return;
+        }
+        _rangeCheck(x, 0, nColumns, _height);
+
+        if (stride < _height) {
+            throw invalid_argument(u8"grid::transposeInto stride (", stride, u8") < height (", _height, u8")");
+        }
+        if (out.size() < (nColumns - 1) * stride + _height) {
+            throw out_of_range(u8"grid::transposeInto output too small");
+        }
+
+        const T* const src = _grid.data() + x;
+        T* const dest = out.data();
+
+        for (unsigned by = 0; by < _height; by += BLOCK_SIZE) {
+            const unsigned yEnd = std::min(by + BLOCK_SIZE, _height);
+
+            for (unsigned bx = 0; bx < nColumns; bx += BLOCK_SIZE) {
+                const unsigned xEnd = std::min(bx + BLOCK_SIZE, nColumns);
+
+                for (unsigned c = bx; c < xEnd; c++) {
+                    const T* s = src + c;
+                    T* d = dest + c * stride;
+
+                    for (unsigned r = by; r < yEnd; r++) {
+                        d[r] = s[r * _width];
+                    }
+                }
+            }
+        }
+    }
+    inline void transposeInto(std::span<T> out, const size_t stride) const
+    {
+        transposeInto(out, stride, 0, _width);
+    }
+
     // Returns a NEW grid, resized to newSize with all new cells containing value
     grid resized(const unsigned newWidth, const unsigned newHeight, const T& value) const
     {
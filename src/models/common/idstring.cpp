@@ -0,0 +1,81 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "idstring.h"
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
+namespace UnTech {
+
+constinit const idstring::InternedString idstring::EMPTY{};
+
+size_t idstring::emptyHash()
+{
+    static const size_t hash = std::hash<std::u8string_view>{}({});
+    return hash;
+}
+
+namespace {
+
+struct InternedStringHash {
+    using is_transparent = void;
+
+    size_t operator()(const idstring::InternedString& s) const { return s.hash; }
+    size_t operator()(const std::u8string_view s) const { return std::hash<std::u8string_view>{}(s); }
+};
+
+struct InternedStringEqual {
+    using is_transparent = void;
+
+    bool operator()(const idstring::InternedString& a, const idstring::InternedString& b) const { return a.str == b.str; }
+    bool operator()(const std::u8string_view a, const idstring::InternedString& b) const { return a == b.str; }
+    bool operator()(const idstring::InternedString& a, const std::u8string_view b) const { return a.str == b; }
+};
+
+// The pool is never shrunk, pooled strings are valid for the lifetime of the program.
+//
+// std::unordered_set elements are not moved when the set is rehashed.
+struct InternPool {
+    std::shared_mutex mutex;
+    std::unordered_set<idstring::InternedString, InternedStringHash, InternedStringEqual> strings;
+};
+
+}
+
+// Function static to prevent a static initialization order fiasco.
+static InternPool& internPool()
+{
+    static InternPool pool;
+    return pool;
+}
+
+const idstring::InternedString* idstring::intern(const std::u8string_view s)
+{
+    if (s.empty()) {
+        return &EMPTY;
+    }
+
+    InternPool& pool = internPool();
+    const size_t hash = InternedStringHash{}(s);
+
+    {
+        std::shared_lock lock(pool.mutex);
+
+        auto it = pool.strings.find(s);
+        if (it != pool.strings.end()) {
+            return &*it;
+        }
+    }
+
+    std::lock_guard lock(pool.mutex);
+
+    // `s` may have been added to the pool by a different thread
+    auto it = pool.strings.emplace(InternedString{ std::u8string(s), hash }).first;
+    return &*it;
+}
+
+}
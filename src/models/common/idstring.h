@@ -8,26 +8,43 @@
 
 #include <algorithm>
 #include <cassert>
+#include <compare>
 #include <string>
 #include <string_view>
 
-namespace UnTech {
-class idstring;
-}
-namespace ImGui {
-bool InputIdstring(const char*, UnTech::idstring*);
-}
-
 namespace UnTech {
 
 // Will ALWAYS contain valid data.
 // Data structure fails silently
+//
+// idstrings are interned in a process-wide pool, copying an idstring does
+// not allocate memory and two idstrings are equal if they point to the same
+// pooled string.
 class idstring {
-    // Allow ImGui::InputIdstring to access idstring internals.
-    friend bool ImGui::InputIdstring(const char*, idstring*);
+public:
+    struct InternedString {
+        std::u8string str;
+        size_t hash = 0;
+    };
 
 private:
-    std::u8string data;
+    static const InternedString EMPTY;
+
+    // Never nullptr
+    const InternedString* data = &EMPTY;
+
+    constexpr explicit idstring(const InternedString* d)
+        : data(d)
+    {
+    }
+
+    // `std::hash<std::u8string>` of an empty string.
+    // Not stored in `EMPTY`, `std::hash` cannot be constant initialized.
+    static size_t emptyHash();
+
+    // Returns the pooled string with the same value as `s`, adding it to the pool if necessary.
+    // Thread safe.
+    static const InternedString* intern(std::u8string_view s);
 
 public:
     static constexpr bool isCharValid(const char c)
@@ -49,14 +66,11 @@ public:
         return std::all_of(name.begin(), name.end(), isCharValid);
     }
 
-    static constexpr idstring fixup(const std::u8string& s)
+    static idstring fixup(std::u8string s)
     {
-        idstring ret;
-
-        ret.data = s;
-        std::replace_if(ret.data.begin(), ret.data.end(), isCharInvalid, u8'_');
+        std::replace_if(s.begin(), s.end(), isCharInvalid, u8'_');
 
-        return ret;
+        return idstring(intern(s));
     }
 
 public:
@@ -68,42 +82,39 @@ public:
 
     constexpr idstring() = default;
 
-    static constexpr idstring fromString(std::u8string&& s)
+    static idstring fromString(const std::u8string_view s)
     {
-        idstring out;
         if (isValid(s)) {
-            out.data = std::move(s);
+            return idstring(intern(s));
         }
-
-        return out;
+        return idstring();
     }
 
-    static constexpr idstring fromString(const std::u8string_view s)
-    {
-        idstring out;
-        if (isValid(s)) {
-            out.data = s;
-        }
-
-        return out;
-    }
-
-    static constexpr idstring fromString(const char8_t* s)
+    static idstring fromString(const char8_t* s)
     {
         return fromString(std::u8string_view(s));
     }
 
-    [[nodiscard]] inline bool isValid() const { return !data.empty(); }
+    [[nodiscard]] inline bool isValid() const { return data != &EMPTY; }
 
     // clang-format off
-    [[nodiscard]] inline const std::u8string& str() const { return data; }
-    [[nodiscard]] inline const char8_t* c_str() const { return data.c_str(); }
+    [[nodiscard]] inline const std::u8string& str() const { return data->str; }
+    [[nodiscard]] inline const char8_t* c_str() const { return data->str.c_str(); }
     // clang-format on
 
-    void clear() { data.clear(); }
+    // Precomputed `std::hash<std::u8string>` of `str()`
+    [[nodiscard]] inline size_t hash() const { return isValid() ? data->hash : emptyHash(); }
 
-    bool operator==(const idstring& o) const = default;
-    auto operator<=>(const idstring& o) const = default;
+    void clear() { data = &EMPTY; }
+
+    bool operator==(const idstring& o) const { return data == o.data; }
+    std::strong_ordering operator<=>(const idstring& o) const
+    {
+        if (data == o.data) {
+            return std::strong_ordering::equal;
+        }
+        return data->str <=> o.data->str;
+    }
 };
 
 inline idstring operator""_id(const char8_t* str, const size_t size)
@@ -137,9 +148,6 @@ namespace std {
 template <>
 struct hash<UnTech::idstring> {
     hash() = default;
-    inline size_t operator()(const UnTech::idstring& id) const { return strHash(id.str()); };
-
-private:
-    hash<std::u8string> strHash;
+    inline size_t operator()(const UnTech::idstring& id) const { return id.hash(); };
 };
 }
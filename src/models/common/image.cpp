@@ -7,6 +7,7 @@
 #include "image.h"
 #include "file.h"
 #include "stringbuilder.h"
+#include "models/common/profiler.h"
 #include "models/common/u8strings.h"
 #include "vendor/lodepng/lodepng.h"
 
@@ -69,6 +70,8 @@ void Image::fill(const rgba& color)
 
 std::shared_ptr<Image> Image::loadPngImage_shared(const std::filesystem::path& filename)
 {
+    const Profiler::ScopedSpan span(u8"PngDecode", filename.u8string());
+
     static constexpr size_t IMAGE_FILE_LIMIT = 2 * 1024 * 1024;
 
     std::vector<uint8_t> fileData;
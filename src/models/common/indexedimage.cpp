@@ -7,6 +7,7 @@
 #include "indexedimage.h"
 #include "file.h"
 #include "stringbuilder.h"
+#include "models/common/profiler.h"
 #include "models/common/u8strings.h"
 #include "vendor/lodepng/lodepng.h"
 
@@ -66,6 +67,8 @@ void IndexedImage::fill(uint8_t color)
 
 std::shared_ptr<IndexedImage> IndexedImage::loadPngImage_shared(const std::filesystem::path& filename)
 {
+    const Profiler::ScopedSpan span(u8"PngDecode", filename.u8string());
+
     static constexpr size_t IMAGE_FILE_LIMIT = 2 * 1024 * 1024;
 
     std::vector<uint8_t> fileData;
@@ -0,0 +1,165 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "profiler.h"
+#include "stringbuilder.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace UnTech::Profiler {
+
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Span> spans;
+    unsigned threadId{};
+};
+
+// Holds a reference to every thread buffer (including buffers of threads that have ended).
+struct BufferList {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+static BufferList& bufferList()
+{
+    static BufferList list;
+    return list;
+}
+
+static ThreadBuffer& threadBuffer()
+{
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto b = std::make_shared<ThreadBuffer>();
+
+        auto& list = bufferList();
+        std::lock_guard lock(list.mutex);
+
+        b->threadId = list.buffers.size() + 1;
+        list.buffers.push_back(b);
+
+        return b;
+    }();
+
+    return *buffer;
+}
+
+static void writeJsonString(std::u8string& out, const std::u8string_view str)
+{
+    out.push_back(u8'"');
+    for (const char8_t c : str) {
+        switch (c) {
+        case u8'"':
+            out.append(u8"\\\"");
+            break;
+
+        case u8'\\':
+            out.append(u8"\\\\");
+            break;
+
+        default:
+            if (c < 0x20) {
+                // Control characters are not expected in span names or details
+                out.push_back(u8' ');
+            }
+            else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back(u8'"');
+}
+
+namespace Private {
+std::atomic_bool enabled = false;
+
+void addSpan(const std::u8string_view name, std::u8string&& detail, const Clock::time_point start, const Clock::time_point end)
+{
+    auto& buffer = threadBuffer();
+
+    std::lock_guard lock(buffer.mutex);
+
+    buffer.spans.push_back({
+        .name = name,
+        .detail = std::move(detail),
+        .start = start,
+        .duration = end - start,
+        .threadId = buffer.threadId,
+    });
+}
+}
+
+void setEnabled(bool e)
+{
+    Private::enabled.store(e, std::memory_order_relaxed);
+}
+
+std::vector<Span> takeSpans()
+{
+    std::vector<Span> out;
+
+    auto& list = bufferList();
+    std::lock_guard listLock(list.mutex);
+
+    for (auto& buffer : list.buffers) {
+        std::lock_guard lock(buffer->mutex);
+
+        std::move(buffer->spans.begin(), buffer->spans.end(), std::back_inserter(out));
+        buffer->spans.clear();
+    }
+
+    std::stable_sort(out.begin(), out.end(),
+                     [](const Span& a, const Span& b) { return a.start < b.start; });
+
+    return out;
+}
+
+std::u8string chromeTraceJson(const std::vector<Span>& spans)
+{
+    using namespace std::chrono;
+
+    const auto origin = spans.empty() ? Clock::time_point{} : spans.front().start;
+
+    std::u8string out;
+    out.reserve(128 * (spans.size() + 1));
+
+    out.append(u8"{\"traceEvents\":[");
+
+    bool first = true;
+
+    for (const Span& s : spans) {
+        if (!first) {
+            out.push_back(u8',');
+        }
+        first = false;
+
+        const auto ts = duration_cast<microseconds>(s.start - origin).count();
+        const auto dur = duration_cast<microseconds>(s.duration).count();
+
+        out.append(u8"\n{\"name\":");
+        writeJsonString(out, s.name);
+        out.append(u8",\"cat\":\"untech\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+        StringBuilder::concat(out, uint32_t(s.threadId));
+        out.append(u8",\"ts\":");
+        StringBuilder::concat(out, int64_t(ts));
+        out.append(u8",\"dur\":");
+        StringBuilder::concat(out, int64_t(dur));
+
+        if (!s.detail.empty()) {
+            out.append(u8",\"args\":{\"detail\":");
+            writeJsonString(out, s.detail);
+            out.push_back(u8'}');
+        }
+
+        out.push_back(u8'}');
+    }
+
+    out.append(u8"\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return out;
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace UnTech::Profiler {
+
+using Clock = std::chrono::steady_clock;
+
+struct Span {
+    // MUST point to a string literal
+    std::u8string_view name;
+
+    // Optional details (ie, the name of the resource being compiled)
+    std::u8string detail;
+
+    Clock::time_point start;
+    Clock::duration duration;
+
+    unsigned threadId;
+};
+
+namespace Private {
+extern std::atomic_bool enabled;
+
+void addSpan(std::u8string_view name, std::u8string&& detail, Clock::time_point start, Clock::time_point end);
+}
+
+// The profiler is disabled by default.
+// No spans are recorded while the profiler is disabled.
+inline bool isEnabled() { return Private::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool e);
+
+// Records the time between construction and destruction.
+//
+// Spans are stored in a per-thread buffer, the only locking done when a span is
+// recorded is an uncontended per-thread mutex (required by `takeSpans()`).
+class ScopedSpan {
+    const std::u8string_view _name;
+    std::u8string _detail;
+    const bool _enabled;
+    Clock::time_point _start;
+
+public:
+    // name MUST point to a string literal
+    explicit ScopedSpan(const std::u8string_view name)
+        : _name(name)
+        , _detail()
+        , _enabled(isEnabled())
+        , _start(_enabled ? Clock::now() : Clock::time_point{})
+    {
+    }
+
+    ScopedSpan(const std::u8string_view name, std::u8string_view detail)
+        : _name(name)
+        , _detail()
+        , _enabled(isEnabled())
+        , _start()
+    {
+        if (_enabled) {
+            _detail = detail;
+            _start = Clock::now();
+        }
+    }
+
+    ~ScopedSpan()
+    {
+        if (_enabled) {
+            Private::addSpan(_name, std::move(_detail), _start, Clock::now());
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan(ScopedSpan&&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(ScopedSpan&&) = delete;
+};
+
+// Removes all recorded spans from the per-thread buffers.
+// Spans are sorted by start time.
+[[nodiscard]] std::vector<Span> takeSpans();
+
+// Returns the spans in the Chrome Trace Event JSON format.
+// (viewable in `chrome://tracing` or Perfetto)
+[[nodiscard]] std::u8string chromeTraceJson(const std::vector<Span>& spans);
+
+}
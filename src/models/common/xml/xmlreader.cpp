@@ -8,6 +8,7 @@
 #include "xml-is-name.h"
 #include "../base64.h"
 #include "../file.h"
+#include "../profiler.h"
 #include "../stringparser.hpp"
 #include "../u8strings.h"
 #include <cassert>
@@ -118,6 +119,8 @@ XmlReader::XmlReader(std::u8string&& xml, std::filesystem::path filePath)
 
 std::unique_ptr<XmlReader> XmlReader::fromFile(const std::filesystem::path& filePath)
 {
+    const Profiler::ScopedSpan span(u8"XmlParse", filePath.u8string());
+
     std::u8string xml = File::readUtf8TextFile(filePath);
     return std::make_unique<XmlReader>(std::move(xml), filePath);
 }
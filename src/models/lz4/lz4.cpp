@@ -10,6 +10,7 @@
 
 #include "lz4.h"
 #include "models/common/exceptions.h"
+#include "models/common/profiler.h"
 #include "models/common/stringbuilder.h"
 #include "vendor/lz4/lib/lz4hc.h"
 #include <span>
@@ -19,6 +20,8 @@ namespace UnTech {
 std::vector<uint8_t>
 lz4HcCompress(const std::vector<uint8_t>& source, unsigned limit)
 {
+    const Profiler::ScopedSpan span(u8"lz4HcCompress");
+
     if (limit > UINT16_MAX
         || source.size() > UINT16_MAX) {
 
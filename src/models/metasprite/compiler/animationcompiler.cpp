@@ -14,8 +14,8 @@ namespace UnTech::MetaSprite::Compiler {
 namespace MS = UnTech::MetaSprite::MetaSprite;
 namespace ANI = UnTech::MetaSprite::Animation;
 
-template <typename T>
-static inline auto indexOf_throw(const std::vector<T>& vector, const T& item)
+template <typename T, typename Allocator>
+static inline auto indexOf_throw(const std::vector<T, Allocator>& vector, const T& item)
 {
     auto it = std::find(vector.begin(), vector.end(), item);
 
@@ -8,202 +8,314 @@
 #include "tilesetlayout.h"
 #include "models/common/iterators.h"
 #include <algorithm>
-#include <climits>
-#include <list>
+#include <bit>
+#include <cassert>
+#include <queue>
 
 namespace UnTech::MetaSprite::Compiler::CombineSmallTiles {
 
-// This is a simple packing algorithm
-// It just pairs off the most common small tiles,
-// and then pairs them again.
+// The small tiles are paired off, then the pairs are paired again to form the Tile16s.
+//
+// Each pairing is a matching on a graph where the weight of an edge is the
+// number of exported frames that use both items.  Maximising the weight of the
+// matching minimises the number of Tile16 tiles each frame uses (which reduces
+// the DMA transfers of dynamic tilesets).
 
 namespace MS = UnTech::MetaSprite::MetaSprite;
 
-struct TileGraphItem {
-    // Graph of tileId => frame indexes that use that tile.
-    // frames may be repeated if the same tile is used multiple times in the same frame (including flipped frames).
+// A set of export frame indexes
+class FrameBitset {
+    std::vector<uint64_t> _words;
 
-    unsigned tileId;
-    std::vector<unsigned> frames;
-
-    TileGraphItem()
-        : tileId(INVALID_SMALL_TILE)
-        , frames()
+public:
+    explicit FrameBitset(size_t nFrames)
+        : _words((nFrames + 63) / 64, 0)
     {
     }
-    TileGraphItem(unsigned t, std::vector<unsigned>&& f)
-        : tileId(t)
-        , frames(std::move(f))
+
+    void set(const unsigned i) { _words.at(i / 64) |= uint64_t(1) << (i % 64); }
+
+    [[nodiscard]] unsigned count() const
     {
+        unsigned c = 0;
+        for (const auto w : _words) {
+            c += std::popcount(w);
+        }
+        return c;
     }
-};
 
-struct FirstPassOutput {
-    const TileGraphItem& firstTile;
-    const TileGraphItem& secondTile;
+    // Returns the number of frames in both `this` and `o`
+    [[nodiscard]] unsigned countAnd(const FrameBitset& o) const
+    {
+        assert(_words.size() == o._words.size());
 
-    FirstPassOutput(const TileGraphItem& first, const TileGraphItem& second)
-        : firstTile(first)
-        , secondTile(second)
+        unsigned c = 0;
+        for (const auto i : range(_words.size())) {
+            c += std::popcount(_words[i] & o._words[i]);
+        }
+        return c;
+    }
+
+    [[nodiscard]] FrameBitset operator|(const FrameBitset& o) const
     {
+        assert(_words.size() == o._words.size());
+
+        FrameBitset out = *this;
+        for (const auto i : range(_words.size())) {
+            out._words[i] |= o._words[i];
+        }
+        return out;
     }
+};
 
-    [[nodiscard]] size_t nFrames() const { return firstTile.frames.size() + secondTile.frames.size(); }
+struct Pair {
+    unsigned first;
+    unsigned second;
 };
 
-static int scoreTilesVec(const std::vector<unsigned>& a, const std::vector<unsigned>& b)
+// Greedy matching.
+//
+// The pairs that share the most frames are matched first (using a heap of
+// candidate pairs).  Items that do not share a frame with any unmatched item
+// are paired off by popularity.
+//
+// `sets` MUST be sorted by popularity (most popular first) and contain an even number of items.
+static std::vector<Pair> greedyMatching(const std::vector<FrameBitset>& sets)
 {
-    int score = 0;
-    for (const auto& f : a) {
-        int count = std::count(b.begin(), b.end(), f);
-        if (count > 0) {
-            score += count;
+    assert(sets.size() % 2 == 0);
+
+    struct Candidate {
+        unsigned score;
+        unsigned a;
+        unsigned b;
+
+        // Highest score first, then the most popular items
+        bool operator<(const Candidate& o) const
+        {
+            if (score != o.score) {
+                return score < o.score;
+            }
+            if (a != o.a) {
+                return a > o.a;
+            }
+            return b > o.b;
         }
-        else {
-            score -= 3;
+    };
+
+    std::vector<Candidate> candidates;
+    for (const auto a : range(sets.size())) {
+        for (const auto b : range(a + 1, sets.size())) {
+            const unsigned score = sets[a].countAnd(sets[b]);
+            if (score > 0) {
+                candidates.push_back({ score, unsigned(a), unsigned(b) });
+            }
         }
     }
-    return score;
-}
 
-static int scoreTiles(const TileGraphItem& a, const TileGraphItem& b)
-{
-    return scoreTilesVec(a.frames, b.frames)
-           + scoreTilesVec(b.frames, a.frames);
-}
+    std::priority_queue<Candidate> heap(std::less<Candidate>(), std::move(candidates));
 
-static int scoreTiles(const FirstPassOutput& a, const FirstPassOutput& b)
-{
-    return scoreTiles(a.firstTile, b.firstTile)
-           + scoreTiles(a.secondTile, b.firstTile)
-           + scoreTiles(b.firstTile, a.secondTile)
-           + scoreTiles(a.secondTile, b.secondTile);
-}
+    std::vector<Pair> out;
+    out.reserve(sets.size() / 2);
 
-// To improve packing the size of the output is always a multiple of four (4).
-static std::vector<TileGraphItem> buildSmallTileGraph(const MetaSprite::FrameSet& frameSet,
-                                                      const std::vector<ExportIndex>& frameEntries)
-{
-    std::vector<std::vector<unsigned>> tileFrames(frameSet.smallTileset.size());
-    for (const auto& fle : frameEntries) {
-        const auto frame = frameSet.frames.at(fle.fsIndex);
+    std::vector<bool> matched(sets.size(), false);
 
-        for (const auto& obj : frame.objects) {
-            if (obj.size == ObjectSize::SMALL) {
-                tileFrames.at(obj.tileId).emplace_back(fle.fsIndex);
+    while (!heap.empty()) {
+        const Candidate c = heap.top();
+        heap.pop();
+
+        if (!matched[c.a] && !matched[c.b]) {
+            matched[c.a] = true;
+            matched[c.b] = true;
+            out.push_back({ c.a, c.b });
+        }
+    }
+
+    int unpaired = -1;
+    for (const auto i : range(sets.size())) {
+        if (!matched[i]) {
+            if (unpaired >= 0) {
+                out.push_back({ unsigned(unpaired), unsigned(i) });
+                unpaired = -1;
+            }
+            else {
+                unpaired = i;
             }
         }
     }
+    assert(unpaired < 0);
+    assert(out.size() == sets.size() / 2);
 
-    std::vector<TileGraphItem> smallTileGraph;
-    smallTileGraph.reserve(int((frameSet.smallTileset.size() + 3) / 4) * 4);
+    return out;
+}
 
-    for (auto [i, tf] : enumerate(tileFrames)) {
-        if (not tf.empty()) {
-            smallTileGraph.emplace_back(i, std::move(tf));
+// Improves a matching by repeatedly swapping the partners of two pairs
+// whenever the swap increases the weight of the matching (2-opt local search).
+//
+// This is an approximation of a maximum-weight matching, it finishes when no
+// swap improves the matching (or after `MAX_SWEEPS` sweeps).
+static void improveMatching(std::vector<Pair>& pairs, const std::vector<FrameBitset>& sets)
+{
+    constexpr unsigned MAX_SWEEPS = 32;
+
+    const size_t n = sets.size();
+
+    std::vector<uint16_t> weights(n * n, 0);
+    for (const auto a : range(n)) {
+        for (const auto b : range(a + 1, n)) {
+            const auto w = sets[a].countAnd(sets[b]);
+            weights[a * n + b] = w;
+            weights[b * n + a] = w;
         }
     }
 
-    while (smallTileGraph.size() % 4 != 0) {
-        smallTileGraph.emplace_back();
-    }
+    auto weight = [&](unsigned a, unsigned b) { return int(weights[a * n + b]); };
 
-    return smallTileGraph;
+    for ([[maybe_unused]] const auto sweep : range(MAX_SWEEPS)) {
+        bool improved = false;
+
+        for (const auto i : range(pairs.size())) {
+            for (const auto j : range(i + 1, pairs.size())) {
+                Pair& p = pairs[i];
+                Pair& q = pairs[j];
+
+                const int current = weight(p.first, p.second) + weight(q.first, q.second);
+                const int swapA = weight(p.first, q.first) + weight(p.second, q.second);
+                const int swapB = weight(p.first, q.second) + weight(p.second, q.first);
+
+                if (swapA > current && swapA >= swapB) {
+                    std::swap(p.second, q.first);
+                    improved = true;
+                }
+                else if (swapB > current) {
+                    std::swap(p.second, q.second);
+                    improved = true;
+                }
+            }
+        }
+
+        if (!improved) {
+            break;
+        }
+    }
 }
 
-static std::list<FirstPassOutput> firstPass(const std::vector<TileGraphItem>& smallTileGraph)
+static std::vector<Pair> matchPairs(const std::vector<FrameBitset>& sets, const SmallTileMatching matching)
 {
-    assert(!smallTileGraph.empty() && smallTileGraph.size() % 4 == 0);
+    auto pairs = greedyMatching(sets);
 
-    std::list<FirstPassOutput> output;
+    if (matching == SmallTileMatching::OPTIMISED) {
+        improveMatching(pairs, sets);
+    }
 
-    std::vector<std::reference_wrapper<const TileGraphItem>> toProcess;
-    toProcess.reserve(smallTileGraph.size());
-    for (const TileGraphItem& it : smallTileGraph) {
-        // cppcheck-suppress useStlAlgorithm
-        toProcess.emplace_back(it);
+    // Place the most popular item first (`sets` is sorted by popularity)
+    for (auto& p : pairs) {
+        if (p.second < p.first) {
+            std::swap(p.first, p.second);
+        }
     }
+    std::sort(pairs.begin(), pairs.end(),
+              [](const Pair& a, const Pair& b) { return a.first < b.first; });
 
-    // sort toProcess by popularity
-    std::stable_sort(toProcess.begin(), toProcess.end(),
-                     [](const TileGraphItem& a, const TileGraphItem& b) {
-                         return a.frames.size() > b.frames.size();
-                     });
+    return pairs;
+}
 
-    while (!toProcess.empty()) {
-        assert(toProcess.size() % 2 == 0);
+struct SmallTileGraph {
+    // Sorted by popularity (most popular first)
+    std::vector<uint16_t> tileIds;
+    std::vector<FrameBitset> frames;
+};
 
-        // The most-popular element is the first element in `toProcess`.
-        // Using a constant reference (instead of an iterator) prevents a
-        // "Using iterator to local container 'toProcess' that may be invalid. [invalidContainer]" cppcheck error
-        const auto& mostPopular = toProcess.front();
+// To improve packing the size of the output is always a multiple of four (4).
+static SmallTileGraph buildSmallTileGraph(const MS::FrameSet& frameSet,
+                                          const std::pmr::vector<ExportIndex>& frameEntries)
+{
+    std::vector<FrameBitset> tileFrames(frameSet.smallTileset.size(), FrameBitset(frameEntries.size()));
+    std::vector<bool> tileUsed(frameSet.smallTileset.size(), false);
 
-        auto bestMatchIt = toProcess.end();
-        {
-            int bestScore = INT_MIN;
-            for (auto it = toProcess.begin() + 1; it != toProcess.end(); ++it) {
-                int score = scoreTiles(*it, mostPopular);
+    for (const auto [i, fle] : const_enumerate(frameEntries)) {
+        const auto& frame = frameSet.frames.at(fle.fsIndex);
 
-                if (score > bestScore) {
-                    bestMatchIt = it;
-                    bestScore = score;
-                }
+        for (const auto& obj : frame.objects) {
+            if (obj.size == ObjectSize::SMALL) {
+                tileFrames.at(obj.tileId).set(i);
+                tileUsed.at(obj.tileId) = true;
             }
         }
-        assert(bestMatchIt != toProcess.end());
+    }
+
+    std::vector<std::pair<unsigned, uint16_t>> order;
+    for (const auto [tileId, used] : const_enumerate(tileUsed)) {
+        if (used) {
+            order.emplace_back(tileFrames.at(tileId).count(), tileId);
+        }
+    }
 
-        output.emplace_back(mostPopular, *bestMatchIt);
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
 
-        toProcess.erase(bestMatchIt);
+    SmallTileGraph graph;
+    graph.tileIds.reserve((order.size() + 3) / 4 * 4);
+    graph.frames.reserve((order.size() + 3) / 4 * 4);
 
-        // Remove `mostPopular`
-        toProcess.erase(toProcess.begin());
+    for (const auto& [count, tileId] : order) {
+        graph.tileIds.push_back(tileId);
+        graph.frames.push_back(std::move(tileFrames.at(tileId)));
     }
 
-    return output;
+    while (graph.tileIds.size() % 4 != 0) {
+        graph.tileIds.push_back(INVALID_SMALL_TILE);
+        graph.frames.emplace_back(frameEntries.size());
+    }
+
+    return graph;
 }
 
-static SmallTileMap_t secondPass(std::list<FirstPassOutput>& input,
-                                 const size_t nSmallTiles)
+static SmallTileMap_t combineTiles(const SmallTileGraph& graph, const size_t nSmallTiles, const SmallTileMatching matching)
 {
-    assert(!input.empty() && input.size() % 2 == 0);
+    assert(!graph.tileIds.empty() && graph.tileIds.size() % 4 == 0);
 
-    SmallTileMap_t output(nSmallTiles, INVALID_SMALL_TILES_ARRAY);
+    // First pass: pair off the small tiles
+    const auto tilePairs = matchPairs(graph.frames, matching);
 
-    // sort the input by popularity
-    // should be mostly sorted anyways
-    input.sort([](const FirstPassOutput& a, const FirstPassOutput& b) {
-        return a.nFrames() > b.nFrames();
-    });
+    std::vector<FrameBitset> pairFrames;
+    pairFrames.reserve(tilePairs.size());
+    for (const auto& p : tilePairs) {
+        pairFrames.push_back(graph.frames.at(p.first) | graph.frames.at(p.second));
+    }
 
-    while (!input.empty()) {
-        auto mostPopular = input.begin();
+    // Second pass: pair off the pairs
+    // The pairs are sorted by popularity to match the `matchPairs` precondition.
+    std::vector<unsigned> pairOrder(tilePairs.size());
+    for (const auto i : range(pairOrder.size())) {
+        pairOrder[i] = i;
+    }
+    std::vector<unsigned> pairCount(tilePairs.size());
+    for (const auto i : range(pairCount.size())) {
+        pairCount[i] = pairFrames[i].count();
+    }
+    std::stable_sort(pairOrder.begin(), pairOrder.end(),
+                     [&](unsigned a, unsigned b) { return pairCount[a] > pairCount[b]; });
 
-        auto bestMatch = input.end();
-        {
-            int bestScore = INT_MIN;
-            auto it = mostPopular;
-            for (++it; it != input.end(); ++it) {
-                int score = scoreTiles(*mostPopular, *it);
-
-                if (score > bestScore) {
-                    bestMatch = it;
-                    bestScore = score;
-                }
-            }
-        }
+    std::vector<FrameBitset> sortedPairFrames;
+    sortedPairFrames.reserve(pairOrder.size());
+    for (const auto i : pairOrder) {
+        sortedPairFrames.push_back(std::move(pairFrames.at(i)));
+    }
 
-        assert(bestMatch != input.end());
+    const auto quads = matchPairs(sortedPairFrames, matching);
 
-        std::array<uint16_t, 4> combined{};
+    SmallTileMap_t output(nSmallTiles, INVALID_SMALL_TILES_ARRAY);
 
-        combined[0] = mostPopular->firstTile.tileId;
-        combined[1] = mostPopular->secondTile.tileId;
-        combined[2] = bestMatch->firstTile.tileId;
-        combined[3] = bestMatch->secondTile.tileId;
+    for (const auto& q : quads) {
+        const auto& a = tilePairs.at(pairOrder.at(q.first));
+        const auto& b = tilePairs.at(pairOrder.at(q.second));
 
-        input.erase(bestMatch);
-        input.erase(mostPopular);
+        const std::array<uint16_t, 4> combined = {
+            graph.tileIds.at(a.first),
+            graph.tileIds.at(a.second),
+            graph.tileIds.at(b.first),
+            graph.tileIds.at(b.second),
+        };
 
         for (auto tId : combined) {
             if (tId != INVALID_SMALL_TILE) {
@@ -220,18 +332,18 @@ static SmallTileMap_t secondPass(std::list<FirstPassOutput>& input,
 namespace UnTech::MetaSprite::Compiler {
 
 SmallTileMap_t buildSmallTileMap(const MetaSprite::FrameSet& frameSet,
-                                 const std::vector<ExportIndex>& frameEntries)
+                                 const std::pmr::vector<ExportIndex>& frameEntries,
+                                 const SmallTileMatching matching)
 {
     if (frameSet.smallTileset.empty()) {
         return {};
     }
 
-    auto smallTileGraph = CombineSmallTiles::buildSmallTileGraph(frameSet, frameEntries);
-    if (smallTileGraph.empty()) {
+    const auto smallTileGraph = CombineSmallTiles::buildSmallTileGraph(frameSet, frameEntries);
+    if (smallTileGraph.tileIds.empty()) {
         return {};
     }
-    auto fp = CombineSmallTiles::firstPass(smallTileGraph);
-    return CombineSmallTiles::secondPass(fp, frameSet.smallTileset.size());
+    return CombineSmallTiles::combineTiles(smallTileGraph, frameSet.smallTileset.size(), matching);
 }
 
 }
@@ -14,6 +14,17 @@ namespace UnTech::MetaSprite::Compiler {
 // Mapping of small tileId => The four small tiles that combine to form a Tile16.
 using SmallTileMap_t = std::vector<std::array<uint16_t, 4>>;
 
+enum class SmallTileMatching {
+    // Greedy matching, fast.
+    FAST,
+
+    // Greedy matching refined by a local search.
+    // Slower, but reduces the number of Tile16 tiles used by each frame.
+    // Only useful for dynamic tilesets.
+    OPTIMISED,
+};
+
 SmallTileMap_t buildSmallTileMap(const MetaSprite::FrameSet& frameSet,
-                                 const std::vector<ExportIndex>& frameEntries);
+                                 const std::pmr::vector<ExportIndex>& frameEntries,
+                                 SmallTileMatching matching);
 }
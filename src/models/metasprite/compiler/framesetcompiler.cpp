@@ -10,8 +10,10 @@
 #include "palettecompiler.h"
 #include "tilesetinserter.h"
 #include "tilesetlayout.h"
+#include "models/common/arena.h"
 #include "models/common/errorlist.h"
 #include "models/common/iterators.h"
+#include "models/common/stringstream.h"
 #include "models/metasprite/utsi2utms/utsi2utms.h"
 #include "models/project/project.h"
 
@@ -217,11 +219,12 @@ static void checkExportListSize(const FrameSetExportList& input, ErrorList& err)
 
 static std::shared_ptr<FrameSetData>
 buildOutput(const MetaSprite::FrameSet& frameSet, const ActionPointMapping& actionPointMapping,
-            const FrameSetExportList& exportList, const TilesetLayout& tilesetLayout)
+            const FrameSetExportList& exportList, const TilesetLayout& tilesetLayout,
+            std::pmr::memory_resource* arena)
 {
     auto out = std::make_shared<FrameSetData>();
 
-    out->tileset = processTileset(frameSet, tilesetLayout);
+    out->tileset = processTileset(frameSet, exportList, tilesetLayout, arena);
     out->frames = processFrameList(exportList, out->tileset, actionPointMapping, frameSet);
     out->animations = processAnimations(exportList, frameSet);
     out->palettes = processPalettes(frameSet.palettes);
@@ -249,7 +252,9 @@ compileFrameSet(const MetaSprite::FrameSet& frameSet,
         return nullptr;
     }
 
-    const FrameSetExportList exportList = buildExportList(frameSet, *exportOrder);
+    CompilerArena arena;
+
+    const FrameSetExportList exportList = buildExportList(frameSet, *exportOrder, &arena);
     checkExportListSize(exportList, errorList);
 
     const auto tilesetLayout = layoutTiles(frameSet, exportList.frames, errorList);
@@ -258,7 +263,7 @@ compileFrameSet(const MetaSprite::FrameSet& frameSet,
         return nullptr;
     }
 
-    return buildOutput(frameSet, actionPointMapping, exportList, tilesetLayout);
+    return buildOutput(frameSet, actionPointMapping, exportList, tilesetLayout, &arena);
 }
 
 std::shared_ptr<const FrameSetData>
@@ -285,4 +290,53 @@ compileFrameSet(const FrameSetFile& fs,
     return nullptr;
 }
 
+static void writeExportName(StringStream& out, const idstring& name, const ExportIndex& ei)
+{
+    out.write(name);
+    if (ei.hFlip) {
+        out.write(u8".hFlip");
+    }
+    if (ei.vFlip) {
+        out.write(u8".vFlip");
+    }
+}
+
+void writeDmaReport(StringStream& out, const FrameSetFile& fs, const FrameSetData& fsData,
+                    const Project::ProjectFile& project)
+{
+    const MS::FrameSet* frameSet = fs.msFrameSet ? fs.msFrameSet.get() : fsData.msFrameSet.get();
+    if (frameSet == nullptr) {
+        return;
+    }
+
+    const auto exportOrder = project.frameSetExportOrders.find(frameSet->exportOrder);
+    if (not exportOrder) {
+        return;
+    }
+
+    const FrameSetExportList exportList = buildExportList(*frameSet, *exportOrder);
+    assert(exportList.animations.size() == fsData.animations.size());
+
+    for (const auto aId : range(exportList.animations.size())) {
+        const ExportIndex& ae = exportList.animations.at(aId);
+        const auto& animationData = fsData.animations.at(aId);
+
+        // Skip the animation header (nextAnimation, durationFormat, frameTableSize)
+        for (unsigned i = 3, aFrameId = 0; i + 1 < animationData.size(); i += 2, aFrameId++) {
+            const unsigned frameId = animationData.at(i);
+
+            const ExportIndex& fe = exportList.frames.at(frameId);
+            const auto tilesetIndex = fsData.tileset.tilesetIndexForFrameId(frameId);
+            const DmaEstimate dma = tilesetIndex ? estimateDma(fsData.tileset.dynamicTilesets.at(*tilesetIndex))
+                                                 : DmaEstimate{};
+
+            out.write(frameSet->name, u8",");
+            writeExportName(out, frameSet->animations.at(ae.fsIndex).name, ae);
+            out.write(u8",", aFrameId, u8",");
+            writeExportName(out, frameSet->frames.at(fe.fsIndex).name, fe);
+            out.write(u8",", dma.nTiles, u8",", dma.nBytes, u8",", dma.nTransfers, u8"\n");
+        }
+    }
+}
+
 }
@@ -12,6 +12,10 @@
 #include <cstdint>
 #include <vector>
 
+namespace UnTech {
+class StringStream;
+}
+
 namespace UnTech::MetaSprite::Compiler {
 
 struct FrameData {
@@ -39,4 +43,11 @@ compileFrameSet(const UnTech::MetaSprite::FrameSetFile& fs,
                 const Project::ProjectFile& project, const ActionPointMapping& actionPointMapping,
                 ErrorList& errorList);
 
+// Writes the estimated DMA cost of every exported animation frame
+// as CSV rows (frameSet,animation,animationFrame,frame,tiles,bytes,transfers).
+//
+// Frames without a dynamic tileset do not require a DMA transfer.
+void writeDmaReport(StringStream& out, const UnTech::MetaSprite::FrameSetFile& fs, const FrameSetData& fsData,
+                    const Project::ProjectFile& project);
+
 }
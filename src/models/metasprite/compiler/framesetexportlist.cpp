@@ -14,9 +14,10 @@ namespace MS = UnTech::MetaSprite::MetaSprite;
 using ExportName = FrameSetExportOrder::ExportName;
 
 template <typename T>
-static std::vector<ExportIndex> baseExportList(const NamedList<T>& fsList, const NamedList<ExportName>& exportList)
+static std::pmr::vector<ExportIndex> baseExportList(const NamedList<T>& fsList, const NamedList<ExportName>& exportList,
+                                                    std::pmr::memory_resource* memoryResource)
 {
-    std::vector<ExportIndex> ret;
+    std::pmr::vector<ExportIndex> ret(memoryResource);
     ret.reserve(exportList.size());
 
     for (const auto& en : exportList) {
@@ -43,10 +44,11 @@ static std::vector<ExportIndex> baseExportList(const NamedList<T>& fsList, const
     return ret;
 }
 
-static std::vector<ExportIndex>
-processAnimations(const MS::FrameSet& frameSet, const NamedList<ExportName>& animations)
+static std::pmr::vector<ExportIndex>
+processAnimations(const MS::FrameSet& frameSet, const NamedList<ExportName>& animations,
+                  std::pmr::memory_resource* memoryResource)
 {
-    auto ret = baseExportList(frameSet.animations, animations);
+    auto ret = baseExportList(frameSet.animations, animations, memoryResource);
 
     // Include the animations referenced in the nextAnimation field
     // Must use an old-style for loop, ret is resized inside this loop.
@@ -72,12 +74,13 @@ processAnimations(const MS::FrameSet& frameSet, const NamedList<ExportName>& ani
     return ret;
 }
 
-static std::vector<ExportIndex>
+static std::pmr::vector<ExportIndex>
 processStillFrames(const MS::FrameSet& frameSet,
                    const NamedList<ExportName>& stillFrames,
-                   const std::vector<ExportIndex>& animations)
+                   const std::pmr::vector<ExportIndex>& animations,
+                   std::pmr::memory_resource* memoryResource)
 {
-    auto ret = baseExportList(frameSet.frames, stillFrames);
+    auto ret = baseExportList(frameSet.frames, stillFrames, memoryResource);
 
     // Add frames from animation.
     // Ensure that the frames added are unique.
@@ -105,10 +108,11 @@ processStillFrames(const MS::FrameSet& frameSet,
     return ret;
 }
 
-FrameSetExportList buildExportList(const MS::FrameSet& frameSet, const FrameSetExportOrder& exportOrder)
+FrameSetExportList buildExportList(const MS::FrameSet& frameSet, const FrameSetExportOrder& exportOrder,
+                                   std::pmr::memory_resource* memoryResource)
 {
-    auto animations = processAnimations(frameSet, exportOrder.animations);
-    auto frames = processStillFrames(frameSet, exportOrder.stillFrames, animations);
+    auto animations = processAnimations(frameSet, exportOrder.animations, memoryResource);
+    auto frames = processStillFrames(frameSet, exportOrder.stillFrames, animations, memoryResource);
 
     return {
         std::move(animations),
@@ -10,6 +10,7 @@
 #include "../metasprite.h"
 #include <algorithm>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace UnTech::MetaSprite::Compiler {
@@ -25,12 +26,13 @@ struct ExportIndex {
 };
 
 struct FrameSetExportList {
-    std::vector<ExportIndex> animations;
-    std::vector<ExportIndex> frames;
+    std::pmr::vector<ExportIndex> animations;
+    std::pmr::vector<ExportIndex> frames;
 };
 
 // NOTE: Can return an invalid FrameSetExportList
 FrameSetExportList buildExportList(const MetaSprite::FrameSet& frameSet,
-                                   const FrameSetExportOrder& exportOrder);
+                                   const FrameSetExportOrder& exportOrder,
+                                   std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource());
 
 }
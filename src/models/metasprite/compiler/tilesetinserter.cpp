@@ -10,6 +10,7 @@
 #include "models/common/exceptions.h"
 #include "models/common/iterators.h"
 #include "models/snes/tilesetinserter.h"
+#include <algorithm>
 
 namespace MS = UnTech::MetaSprite::MetaSprite;
 
@@ -54,8 +55,31 @@ struct CharAttrPos {
 
 const std::array<uint16_t, 4> CharAttrPos::SMALL_TILE_OFFSETS = { 0x0000, 0x0001, 0x0010, 0x0011 };
 
+static Snes::Tile16px tile16Pixels(const Tile16& tile16,
+                                   const std::vector<Snes::Tile16px>& largeTileset, const std::vector<Snes::Tile8px>& smallTileset)
+{
+    if (tile16.isLarge()) {
+        return largeTileset.at(tile16.largeTileId);
+    }
+    else {
+        if (tile16.smallTileIds == INVALID_SMALL_TILES_ARRAY) {
+            throw logic_error(u8"Invalid smallTileIds");
+        }
+
+        std::array<Snes::Tile8px, 4> smallTiles = {};
+
+        for (const auto i : range(4)) {
+            unsigned tId = tile16.smallTileIds.at(i);
+            if (tId < smallTileset.size()) {
+                smallTiles.at(i) = smallTileset.at(tId);
+            }
+        }
+        return combineSmallTiles(smallTiles);
+    }
+}
+
 static FrameTilesetData
-insertTiles(const vectorset<Tile16>& tiles, const TilesetType tilesetType,
+insertTiles(const std::vector<Tile16>& tiles, const TilesetType tilesetType,
             const unsigned tileOffset, const FrameTilesetData& staticTileset, const bool dynamicTileset,
             const std::vector<Snes::Tile16px>& largeTileset, const std::vector<Snes::Tile8px>& smallTileset,
             Snes::TilesetInserter16px& tileInserter)
@@ -71,21 +95,14 @@ insertTiles(const vectorset<Tile16>& tiles, const TilesetType tilesetType,
     tileset.largeTilesCharAttr = staticTileset.largeTilesCharAttr;
     tileset.dynamicTileset = dynamicTileset;
 
-    auto addTile = [&](const Snes::Tile16px& tile) mutable {
-        auto a = tileInserter.getOrInsert(tile);
-        tileset.tiles.push_back(a.tileId);
-
-        return a;
-    };
-
     CharAttrPos charAttrPos(tilesetSplitPoint(tilesetType), tileOffset);
 
     for (const Tile16& tile16 : tiles) {
+        const auto a = tileInserter.getOrInsert(tile16Pixels(tile16, largeTileset, smallTileset));
+        tileset.tiles.push_back(a.tileId);
+
         if (tile16.isLarge()) {
             unsigned tId = tile16.largeTileId;
-            const Snes::Tile16px& tile = largeTileset.at(tId);
-
-            const auto a = addTile(tile);
 
             uint16_t charAttr = charAttrPos.largeCharAttr();
             if (a.hFlip) {
@@ -99,20 +116,6 @@ insertTiles(const vectorset<Tile16>& tiles, const TilesetType tilesetType,
             charAttrPos.inc();
         }
         else {
-            if (tile16.smallTileIds == INVALID_SMALL_TILES_ARRAY) {
-                throw logic_error(u8"Invalid smallTileIds");
-            }
-
-            std::array<Snes::Tile8px, 4> smallTiles = {};
-
-            for (const auto i : range(4)) {
-                unsigned tId = tile16.smallTileIds.at(i);
-                if (tId < smallTileset.size()) {
-                    smallTiles.at(i) = smallTileset.at(tId);
-                }
-            }
-            const auto a = addTile(combineSmallTiles(smallTiles));
-
             for (const auto i : range(4)) {
                 auto tId = tile16.smallTileIds.at(i);
 
@@ -153,7 +156,8 @@ insertStaticTileset(const vectorset<Tile16>& tiles, const TilesetType tilesetTyp
     blankTileset.smallTilesCharAttr.resize(smallTileset.size(), nullTile);
 
     if (tiles.empty() == false) {
-        return insertTiles(tiles, tilesetType, tileOffset, blankTileset, false,
+        const std::vector<Tile16> tileVector(tiles.begin(), tiles.end());
+        return insertTiles(tileVector, tilesetType, tileOffset, blankTileset, false,
                            largeTileset, smallTileset, tileInserter);
     }
     else {
@@ -167,15 +171,86 @@ insertDynamicTileset(const std::vector<Tile16>& tiles, const TilesetType tileset
                      const std::vector<Snes::Tile16px>& largeTileset, const std::vector<Snes::Tile8px>& smallTileset,
                      Snes::TilesetInserter16px& tileInserter)
 {
-    return insertTiles(tiles, tilesetType, 0, staticTileset, true,
+    // Sort the tiles by their position in the ROM tile data.
+    // New tiles are appended to the tile data in order, so the tiles that
+    // are not shared with a previously inserted tileset form a single run.
+    std::vector<std::pair<unsigned, Tile16>> romOrder;
+    romOrder.reserve(tiles.size());
+
+    for (const Tile16& tile16 : tiles) {
+        const auto a = tileInserter.getOrInsert(tile16Pixels(tile16, largeTileset, smallTileset));
+        romOrder.emplace_back(a.tileId, tile16);
+    }
+
+    std::stable_sort(romOrder.begin(), romOrder.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<Tile16> sortedTiles;
+    sortedTiles.reserve(romOrder.size());
+    for (const auto& [tileId, tile16] : romOrder) {
+        sortedTiles.push_back(tile16);
+    }
+
+    return insertTiles(sortedTiles, tilesetType, 0, staticTileset, true,
                        largeTileset, smallTileset, tileInserter);
 }
 
-TilesetData processTileset(const MetaSprite::FrameSet& frameSet, const TilesetLayout& tilesetLayout)
+// Returns the order in which the dynamic tilesets are inserted into the ROM tile data.
+//
+// Tilesets are ordered by their first use in the exported animations, so
+// consecutive animation frames are more likely to share contiguous ROM tiles.
+static std::vector<unsigned> dynamicTilesetOrder(const MS::FrameSet& frameSet, const FrameSetExportList& exportList,
+                                                 const TilesetLayout& tilesetLayout)
+{
+    const size_t nTilesets = tilesetLayout.dynamicTiles.size();
+
+    std::vector<unsigned> order;
+    order.reserve(nTilesets);
+
+    std::vector<bool> inserted(nTilesets, false);
+
+    auto addTileset = [&](const int tilesetId) {
+        if (tilesetId >= 0 && !inserted.at(tilesetId)) {
+            inserted.at(tilesetId) = true;
+            order.push_back(tilesetId);
+        }
+    };
+
+    for (const ExportIndex& ae : exportList.animations) {
+        const auto& animation = frameSet.animations.at(ae.fsIndex);
+
+        for (const auto& aFrame : animation.frames) {
+            const auto frameIndex = frameSet.frames.indexOf(aFrame.frame.name);
+            if (!frameIndex) {
+                continue;
+            }
+
+            const ExportIndex fe{ unsigned(*frameIndex),
+                                  static_cast<bool>(aFrame.frame.hFlip ^ ae.hFlip),
+                                  static_cast<bool>(aFrame.frame.vFlip ^ ae.vFlip) };
+
+            const auto it = std::find(exportList.frames.begin(), exportList.frames.end(), fe);
+            if (it != exportList.frames.end()) {
+                addTileset(tilesetLayout.frameTilesets.at(std::distance(exportList.frames.begin(), it)));
+            }
+        }
+    }
+
+    for (const auto i : range(nTilesets)) {
+        addTileset(i);
+    }
+
+    assert(order.size() == nTilesets);
+
+    return order;
+}
+
+TilesetData processTileset(const MetaSprite::FrameSet& frameSet, const FrameSetExportList& exportList,
+                           const TilesetLayout& tilesetLayout, std::pmr::memory_resource* memoryResource)
 {
     TilesetData ret;
 
-    Snes::TilesetInserter16px tileInserter(ret.tiles);
+    Snes::TilesetInserter16px tileInserter(ret.tiles, memoryResource);
 
     ret.tilesetTypeByte = tilesetTypeRomValue(tilesetLayout.tilesetType);
     ret.frameTilesets = tilesetLayout.frameTilesets;
@@ -192,14 +267,31 @@ TilesetData processTileset(const MetaSprite::FrameSet& frameSet, const TilesetLa
                                             frameSet.largeTileset, frameSet.smallTileset,
                                             tileInserter);
 
-    for (const auto& dynTiles : tilesetLayout.dynamicTiles) {
-        ret.dynamicTilesets.push_back(
-            insertDynamicTileset(dynTiles, tilesetLayout.tilesetType, ret.staticTileset,
-                                 frameSet.largeTileset, frameSet.smallTileset,
-                                 tileInserter));
+    ret.dynamicTilesets.resize(tilesetLayout.dynamicTiles.size());
+
+    for (const unsigned i : dynamicTilesetOrder(frameSet, exportList, tilesetLayout)) {
+        ret.dynamicTilesets.at(i) = insertDynamicTileset(tilesetLayout.dynamicTiles.at(i), tilesetLayout.tilesetType, ret.staticTileset,
+                                                         frameSet.largeTileset, frameSet.smallTileset,
+                                                         tileInserter);
     }
 
     return ret;
 }
 
+DmaEstimate estimateDma(const FrameTilesetData& tileset)
+{
+    DmaEstimate out;
+
+    out.nTiles = tileset.tiles.size();
+    out.nBytes = out.nTiles * RomTileData::SNES_TILE16_SIZE;
+
+    for (const auto i : range(tileset.tiles.size())) {
+        if (i == 0 || tileset.tiles.at(i) != tileset.tiles.at(i - 1) + 1) {
+            out.nTransfers++;
+        }
+    }
+
+    return out;
+}
+
 }
@@ -5,8 +5,10 @@
  */
 
 #include "compiler.h"
+#include "framesetexportlist.h"
 #include "../metasprite.h"
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <vector>
 
@@ -55,6 +57,24 @@ struct TilesetData {
     }
 };
 
-TilesetData processTileset(const MetaSprite::FrameSet& frameSet, const TilesetLayout& tilesetLayout);
+// Estimated cost of transferring a dynamic tileset to VRAM.
+struct DmaEstimate {
+    unsigned nTiles = 0;
+    unsigned nBytes = 0;
+
+    // Number of contiguous runs of Tile16s in the ROM tile data.
+    // (Does not take bank boundaries into account)
+    unsigned nTransfers = 0;
+};
+
+// Dynamic tilesets are inserted in animation order and the tiles of each
+// dynamic tileset are sorted by their position in `TilesetData::tiles`
+// to reduce the number of DMA transfers required to load a frame.
+//
+// `memoryResource` is only used for temporary data.
+TilesetData processTileset(const MetaSprite::FrameSet& frameSet, const FrameSetExportList& exportList,
+                           const TilesetLayout& tilesetLayout, std::pmr::memory_resource* memoryResource);
+
+DmaEstimate estimateDma(const FrameTilesetData& tileset);
 
 }
@@ -8,10 +8,12 @@
 #include "combinesmalltiles.h"
 #include "tilesetinserter.h"
 #include "tilesettype.hpp"
+#include "models/common/attributes.h"
 #include "models/common/errorlist.h"
 #include "models/common/iterators.h"
 #include "models/common/vectorset.h"
 #include "models/metasprite/errorlisthelpers.h"
+#include <unordered_map>
 
 namespace UnTech::MetaSprite::Compiler {
 
@@ -33,7 +35,7 @@ static void addFrameToTileset(vectorset<Tile16>& tiles,
     }
 }
 
-static vectorset<Tile16> fixedTilesetData(const std::vector<ExportIndex>& frames,
+static vectorset<Tile16> fixedTilesetData(const std::pmr::vector<ExportIndex>& frames,
                                           const MS::FrameSet& frameSet,
                                           const SmallTileMap_t& smallTileMap)
 {
@@ -57,54 +59,109 @@ struct DynamicTileset {
     }
 };
 
-static std::vector<DynamicTileset> tilesForEachFrame(const std::vector<ExportIndex>& frameEntries,
+static inline size_t hashTile16(const Tile16& tile)
+    __attribute__(IGNORE_UNSIGNED_OVERFLOW_ATTR)
+{
+    size_t seed = tile.largeTileId;
+
+    for (const uint16_t t : tile.smallTileIds) {
+        // numbers from boost
+        seed ^= t + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+}
+
+static inline size_t hashTileset(const vectorset<Tile16>& tiles)
+    __attribute__(IGNORE_UNSIGNED_OVERFLOW_ATTR)
+{
+    size_t seed = tiles.size();
+
+    for (const Tile16& t : tiles) {
+        seed ^= hashTile16(t) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+}
+
+static std::vector<DynamicTileset> tilesForEachFrame(const std::pmr::vector<ExportIndex>& frameEntries,
                                                      const MS::FrameSet& frameSet,
                                                      const SmallTileMap_t& smallTileMap)
 {
     std::vector<DynamicTileset> ret;
 
+    // Maps tileset hash to `ret` index
+    std::unordered_multimap<size_t, unsigned> tilesetMap;
+
     for (auto [frameId, entry] : const_enumerate(frameEntries)) {
-        const auto frame = frameSet.frames.at(entry.fsIndex);
+        const auto& frame = frameSet.frames.at(entry.fsIndex);
 
         vectorset<Tile16> tileset;
         addFrameToTileset(tileset, frame, smallTileMap);
 
-        auto it = std::find_if(ret.begin(), ret.end(),
-                               [&](const auto& i) { return i.tiles == tileset; });
+        const size_t hash = hashTileset(tileset);
+
+        const auto [first, last] = tilesetMap.equal_range(hash);
+        const auto it = std::find_if(first, last,
+                                     [&](const auto& i) { return ret.at(i.second).tiles == tileset; });
 
-        if (it == ret.end()) {
+        if (it == last) {
+            tilesetMap.emplace(hash, ret.size());
             ret.emplace_back(std::move(tileset), frameId);
         }
         else {
             // tileset already exists
-            it->frameIds.push_back(frameId);
+            ret.at(it->second).frameIds.push_back(frameId);
         }
     }
 
     return ret;
 }
 
-static std::vector<std::pair<Tile16, unsigned>> countTileUsage(const std::vector<DynamicTileset>& ftVector)
+struct TileUsage {
+    Tile16 tile;
+
+    // Number of export frames that use this tile
+    unsigned count;
+
+    // The DynamicTileset indexes that contain this tile
+    std::vector<bool> inTileset;
+};
+
+// Returned list is in first-use order
+static std::vector<TileUsage> countTileUsage(const std::vector<DynamicTileset>& ftVector)
 {
-    std::vector<std::pair<Tile16, unsigned>> ret;
-    ret.reserve(128);
+    struct Tile16Hash {
+        size_t operator()(const Tile16& t) const { return hashTile16(t); }
+    };
 
-    for (const auto& ft : ftVector) {
+    std::vector<TileUsage> ret;
+    std::unordered_map<Tile16, unsigned, Tile16Hash> tileIndex;
+
+    for (const auto [ftIndex, ft] : const_enumerate(ftVector)) {
         for (const Tile16& ftTile : ft.tiles) {
-            auto it = std::find_if(ret.begin(), ret.end(),
-                                   [&](const auto& i) { return i.first == ftTile; });
-            if (it == ret.end()) {
-                ret.emplace_back(ftTile, ft.frameIds.size());
-            }
-            else {
-                it->second += ft.frameIds.size();
+            const auto [it, inserted] = tileIndex.try_emplace(ftTile, ret.size());
+            if (inserted) {
+                ret.push_back({ ftTile, 0, std::vector<bool>(ftVector.size(), false) });
             }
+
+            auto& tu = ret.at(it->second);
+            tu.count += ft.frameIds.size();
+            tu.inTileset.at(ftIndex) = true;
         }
     }
 
     return ret;
 }
 
+// Selects the tiles that are always loaded in VRAM.
+//
+// Every static tile removes that tile from the DMA transfers of the frames
+// that use it, but takes a VRAM slot away from the frames that do not use it.
+//
+// The tiles are tested in popularity order (to minimise the number of
+// dynamic tiles transferred by the frames) and a tile is made static if every
+// frame still fits in the tileset afterwards.
 static vectorset<Tile16> calculateStaticTiles(const std::vector<DynamicTileset>& ftVector,
                                               const TilesetType tilesetType)
 {
@@ -113,39 +170,40 @@ static vectorset<Tile16> calculateStaticTiles(const std::vector<DynamicTileset>&
     auto popularTiles = countTileUsage(ftVector);
 
     std::stable_sort(popularTiles.begin(), popularTiles.end(),
-                     [](const auto& l, const auto& r) { return l.second > r.second; });
+                     [](const auto& l, const auto& r) { return l.count > r.count; });
 
-    if (popularTiles.size() > tilesetType_nTiles - 1) {
-        popularTiles.resize(tilesetType_nTiles - 1);
+    // Number of free tile slots in each frame tileset (can be negative if the frame is too large).
+    // Adding a static tile that is not used by the frame reduces the frame's slack by one.
+    std::vector<int> slack(ftVector.size());
+    for (const auto [i, ft] : const_enumerate(ftVector)) {
+        slack.at(i) = int(tilesetType_nTiles) - int(ft.tiles.size());
     }
 
-    while (popularTiles.size() > 0) {
-        unsigned maxDynamicTiles = 0;
+    vectorset<Tile16> ret;
 
-        for (const auto& ft : ftVector) {
-            unsigned nDynamicTiles = ft.tiles.size();
+    for (const auto& tu : popularTiles) {
+        if (ret.size() >= tilesetType_nTiles - 1) {
+            break;
+        }
 
-            for (const auto& tc : popularTiles) {
-                if (ft.tiles.contains(tc.first)) {
-                    nDynamicTiles--;
-                }
-            }
-            if (nDynamicTiles > maxDynamicTiles) {
-                maxDynamicTiles = nDynamicTiles;
+        bool fits = true;
+        for (const auto i : range(ftVector.size())) {
+            if (!tu.inTileset[i] && slack[i] <= 0) {
+                fits = false;
+                break;
             }
         }
 
-        if (maxDynamicTiles + popularTiles.size() <= tilesetType_nTiles) {
-            break;
+        if (fits) {
+            for (const auto i : range(ftVector.size())) {
+                if (!tu.inTileset[i]) {
+                    slack[i]--;
+                }
+            }
+            ret.insert(tu.tile);
         }
-        popularTiles.resize(popularTiles.size() - 1);
     }
 
-    vectorset<Tile16> ret;
-    ret.reserve(popularTiles.size());
-    for (const auto& tc : popularTiles) {
-        ret.insert(tc.first);
-    }
     return ret;
 }
 
@@ -163,14 +221,17 @@ static std::vector<Tile16> tile_difference(const vectorset<Tile16>& tiles,
 }
 
 TilesetLayout layoutTiles(const MS::FrameSet& frameSet,
-                          const std::vector<ExportIndex>& exportFrames,
+                          const std::pmr::vector<ExportIndex>& exportFrames,
                           ErrorList& errorList)
 {
     const TilesetType tilesetType = frameSet.tilesetType;
     const unsigned tilesetType_nTiles = numberOfTilesetTiles(tilesetType);
     const bool tilesetType_isFixed = isFixedTilesetType(tilesetType);
 
-    const auto smallTileMap = buildSmallTileMap(frameSet, exportFrames);
+    // The small tile pairing only affects the number of tiles transferred by dynamic tilesets.
+    const auto matching = tilesetType_isFixed ? SmallTileMatching::FAST : SmallTileMatching::OPTIMISED;
+
+    const auto smallTileMap = buildSmallTileMap(frameSet, exportFrames, matching);
     auto tiles = fixedTilesetData(exportFrames, frameSet, smallTileMap);
 
     TilesetLayout ret;
@@ -42,7 +42,7 @@ struct TilesetLayout {
 };
 
 TilesetLayout layoutTiles(const MetaSprite::FrameSet& frameSet,
-                          const std::vector<ExportIndex>& exportFrames,
+                          const std::pmr::vector<ExportIndex>& exportFrames,
                           ErrorList& errorList);
 
 }
@@ -29,56 +29,74 @@ static constexpr std::array<std::u8string_view, 7> projectSettingNames{
     u8"Scenes",
 };
 
-template <typename T>
-static inline void resizeListAndPopulateNames(CompilerStatus::ListData& listData, const NamedList<T>& list)
+using ResourceStatus = CompilerStatus::ResourceStatus;
+
+// The old entry may still be used by a published snapshot, it is replaced with a modified copy.
+template <typename Function>
+static inline void modifyResource(std::shared_ptr<const ResourceStatus>& entry, Function f)
+{
+    auto rs = std::make_shared<ResourceStatus>(*entry);
+    f(*rs);
+    entry = std::move(rs);
+}
+
+static inline void markResourceUnchecked(std::shared_ptr<const ResourceStatus>& entry)
+{
+    if (entry->state != ResourceState::Unchecked) {
+        modifyResource(entry, [](auto& rs) { rs.state = ResourceState::Unchecked; });
+    }
+}
+
+template <typename Function>
+static inline void resizeList(CompilerStatus::ListData& listData, const size_t size, Function getName)
 {
     listData.state = ResourceState::AllUnchecked;
     listData.resources.clear();
-    listData.resources.resize(list.size());
+    listData.resources.reserve(size);
 
-    for (const auto [i, item] : enumerate(list)) {
-        listData.resources.at(i).name = item.name.str();
+    for (const auto i : range(size)) {
+        auto rs = std::make_shared<ResourceStatus>();
+        rs->name = getName(i);
+        listData.resources.push_back(std::move(rs));
     }
 }
 
 template <typename T>
-static inline void resizeListAndPopulateNames(CompilerStatus::ListData& listData, const ExternalFileList<T>& list)
+static inline void resizeListAndPopulateNames(CompilerStatus::ListData& listData, const NamedList<T>& list)
 {
-    listData.state = ResourceState::AllUnchecked;
-    listData.resources.clear();
-    listData.resources.resize(list.size());
+    resizeList(listData, list.size(), [&](size_t i) { return list.at(i).name.str(); });
+}
 
-    for (const auto [i, item] : enumerate(list)) {
-        auto& rs = listData.resources.at(i);
+template <typename T>
+static inline void resizeListAndPopulateNames(CompilerStatus::ListData& listData, const ExternalFileList<T>& list)
+{
+    resizeList(listData, list.size(), [&](size_t i) {
+        const auto& item = list.item(i);
 
         if (item.value) {
-            rs.name = item.value->name.str();
+            return item.value->name.str();
         }
         else {
-            rs.name = item.filename.filename().u8string();
+            return item.filename.filename().u8string();
         }
-    }
+    });
 }
 
 static inline void resizeListAndPopulateNames(CompilerStatus::ListData& listData, const std::vector<MetaSprite::FrameSetFile>& list)
 {
-    listData.state = ResourceState::AllUnchecked;
-    listData.resources.clear();
-    listData.resources.resize(list.size());
-
-    for (const auto [i, item] : enumerate(list)) {
-        auto& rs = listData.resources.at(i);
+    resizeList(listData, list.size(), [&](size_t i) {
+        const auto& item = list.at(i);
 
         if (item.siFrameSet) {
-            rs.name = item.siFrameSet->name.str();
+            return item.siFrameSet->name.str();
         }
         else if (item.msFrameSet) {
-            rs.name = item.msFrameSet->name.str();
+            return item.msFrameSet->name.str();
         }
         else {
-            rs.name = item.filename.filename().u8string();
+            return item.filename.filename().u8string();
         }
-    }
+    });
 }
 
 inline CompilerStatus::ListData::ListData(std::u8string tnSingle, std::u8string tnPlural)
@@ -89,6 +107,45 @@ inline CompilerStatus::ListData::ListData(std::u8string tnSingle, std::u8string
 {
 }
 
+void CompilerStatus::publish(const std::array<ListData, N_RESOURCE_TYPES>& rl, std::optional<ResourceType> type)
+{
+    auto s = std::make_shared<Snapshot>();
+    s->statusId = getNextCompileId();
+
+    if (type) {
+        const auto old = _snapshot.load(std::memory_order_relaxed);
+        s->lists = old->lists;
+
+        const size_t i = size_t(*type);
+        s->lists.at(i) = std::make_shared<const ListData>(rl.at(i));
+    }
+    else {
+        for (const auto i : range(rl.size())) {
+            s->lists.at(i) = std::make_shared<const ListData>(rl.at(i));
+        }
+    }
+
+    _snapshot.store(std::move(s), std::memory_order_release);
+}
+
+template <typename Function>
+void CompilerStatus::writeResourceLists(Function f)
+{
+    _resourceLists.write([&](auto& rl) {
+        f(rl);
+        publish(rl, std::nullopt);
+    });
+}
+
+template <typename Function>
+void CompilerStatus::writeResourceList(const ResourceType type, Function f)
+{
+    _resourceLists.write([&](auto& rl) {
+        f(rl.at(size_t(type)));
+        publish(rl, type);
+    });
+}
+
 CompilerStatus::CompilerStatus(const ProjectFile& project)
     : _resourceLists({ {
         { u8"Project Settings", u8"Project Settings" },
@@ -100,14 +157,10 @@ CompilerStatus::CompilerStatus(const ProjectFile& project)
         { u8"Room", u8"Rooms" },
     } })
 {
-    _resourceLists.write([](auto& rl) {
+    writeResourceLists([](auto& rl) {
         auto& ps = rl.at(size_t(ResourceType::ProjectSettings));
 
-        ps.resources.resize(projectSettingNames.size());
-
-        for (auto [i, r] : enumerate(ps.resources)) {
-            r.name = projectSettingNames.at(i);
-        }
+        resizeList(ps, projectSettingNames.size(), [](size_t i) { return std::u8string(projectSettingNames.at(i)); });
     });
 
     updateListSizeAndNames(project);
@@ -115,13 +168,13 @@ CompilerStatus::CompilerStatus(const ProjectFile& project)
 
 void CompilerStatus::updateListSizeAndNames(const ProjectFile& pf)
 {
-    _resourceLists.write([&](auto& rl) {
+    writeResourceLists([&](auto& rl) {
         auto getList = [&](ResourceType t) -> ListData& { return rl.at(size_t(t)); };
 
         auto& ps = getList(ResourceType::ProjectSettings);
         ps.state = ResourceState::AllUnchecked;
         for (auto& r : ps.resources) {
-            r.state = ResourceState::Unchecked;
+            markResourceUnchecked(r);
         }
 
         resizeListAndPopulateNames(getList(ResourceType::FrameSetExportOrders), pf.frameSetExportOrders);
@@ -135,17 +188,26 @@ void CompilerStatus::updateListSizeAndNames(const ProjectFile& pf)
 
 void CompilerStatus::markAllUnchecked()
 {
-    _resourceLists.write([&](auto& rl) {
+    writeResourceLists([&](auto& rl) {
         for (auto& ps : rl) {
             ps.state = ResourceState::AllUnchecked;
 
             for (auto& r : ps.resources) {
-                r.state = ResourceState::Unchecked;
+                markResourceUnchecked(r);
             }
         }
     });
 }
 
+// An `AllUnchecked` list must not be downgraded to `Unchecked`,
+// otherwise the DataStore will not be cleared and resized.
+static inline void markListStateUnchecked(CompilerStatus::ListData& listData)
+{
+    if (listData.state != ResourceState::AllUnchecked) {
+        listData.state = ResourceState::Unchecked;
+    }
+}
+
 static inline void updateDependencies(std::array<CompilerStatus::ListData, N_RESOURCE_TYPES>& resourceLists,
                                       ProjectSettingsIndex index)
 {
@@ -154,15 +216,15 @@ static inline void updateDependencies(std::array<CompilerStatus::ListData, N_RES
 
     const auto markPsUnchecked = [&](PSI i) {
         auto& ps = resourceLists.at(size_t(RT::ProjectSettings));
-        ps.state = ResourceState::Unchecked;
-        ps.resources.at(size_t(i)).state = ResourceState::Unchecked;
+        markListStateUnchecked(ps);
+        markResourceUnchecked(ps.resources.at(size_t(i)));
     };
 
     const auto markListUnchecked = [&](RT t) {
         auto& rl = resourceLists.at(size_t(t));
         rl.state = ResourceState::AllUnchecked;
         for (auto& r : rl.resources) {
-            r.state = ResourceState::Unchecked;
+            markResourceUnchecked(r);
         }
     };
 
@@ -209,21 +271,21 @@ static inline void updateDependencies(std::array<CompilerStatus::ListData, N_RES
 
     const auto markPsUnchecked = [&](PSI i) {
         auto& ps = resourceLists.at(size_t(RT::ProjectSettings));
-        ps.state = ResourceState::Unchecked;
-        ps.resources.at(size_t(i)).state = ResourceState::Unchecked;
+        markListStateUnchecked(ps);
+        markResourceUnchecked(ps.resources.at(size_t(i)));
     };
 
     const auto markUnchecked = [&](RT t, size_t i) {
         auto& rl = resourceLists.at(size_t(t));
-        rl.state = ResourceState::Unchecked;
-        rl.resources.at(i).state = ResourceState::Unchecked;
+        markListStateUnchecked(rl);
+        markResourceUnchecked(rl.resources.at(i));
     };
 
     const auto markListUnchecked = [&](RT t) {
         auto& rl = resourceLists.at(size_t(t));
         rl.state = ResourceState::AllUnchecked;
         for (auto& r : rl.resources) {
-            r.state = ResourceState::Unchecked;
+            markResourceUnchecked(r);
         }
     };
 
@@ -358,9 +420,9 @@ static inline void updateDependencies(std::array<CompilerStatus::ListData, N_RES
 void CompilerStatus::markUnchecked(const ResourceType type, const size_t index, const ProjectFile& pf)
 {
     if (type == ResourceType::ProjectSettings) {
-        _resourceLists.write([&](auto& rl) {
+        writeResourceLists([&](auto& rl) {
             auto& rlist = rl.at(size_t(type));
-            rlist.state = ResourceState::Unchecked;
+            markListStateUnchecked(rlist);
             if (index < rlist.resources.size()) {
                 updateDependencies(rl, ProjectSettingsIndex(index));
             }
@@ -369,19 +431,19 @@ void CompilerStatus::markUnchecked(const ResourceType type, const size_t index,
     else {
         const idstring& name = getName(pf, type, index);
 
-        _resourceLists.write([&](auto& rl) {
+        writeResourceLists([&](auto& rl) {
             auto& rlist = rl.at(size_t(type));
 
-            rlist.state = ResourceState::Unchecked;
+            markListStateUnchecked(rlist);
 
             if (index < rlist.resources.size()) {
                 auto& entry = rlist.resources.at(index);
-                entry.state = ResourceState::Unchecked;
+                markResourceUnchecked(entry);
 
-                if (entry.name != name.str()) {
+                if (entry->name != name.str()) {
                     // Mark resources using the old name Unchecked.
-                    updateDependencies(rl, type, idstring::fromString(entry.name), pf);
-                    entry.name = name.str();
+                    updateDependencies(rl, type, idstring::fromString(entry->name), pf);
+                    modifyResource(entry, [&](auto& rs) { rs.name = name.str(); });
                 }
                 updateDependencies(rl, type, name, pf);
             }
@@ -391,66 +453,89 @@ void CompilerStatus::markUnchecked(const ResourceType type, const size_t index,
 
 bool CompilerStatus::updateResourceListState(const ResourceType type)
 {
-    return _resourceLists.write_and_return_bool([&](auto& rl) {
-        auto& listStatus = rl.at(size_t(type));
+    bool valid = false;
 
-        const bool valid = std::all_of(listStatus.resources.begin(), listStatus.resources.end(),
-                                       [](const auto& r) { return r.state == ResourceState::Valid; });
+    writeResourceList(type, [&](auto& listStatus) {
+        valid = std::all_of(listStatus.resources.begin(), listStatus.resources.end(),
+                            [](const auto& r) { return r->state == ResourceState::Valid; });
         listStatus.state = valid ? ResourceState::Valid : ResourceState::Invalid;
+    });
+
+    return valid;
+}
 
-        return valid;
+void CompilerStatus::dataStoreResized(const ResourceType type)
+{
+    writeResourceList(type, [&](auto& listStatus) {
+        if (listStatus.state == ResourceState::AllUnchecked) {
+            listStatus.state = ResourceState::Unchecked;
+        }
     });
 }
 
-void CompilerStatus::store(const ResourceType type, const size_t index, ResourceState state, ErrorList&& errorList)
+void CompilerStatus::store(const ResourceType type, const size_t index, ResourceState state, ErrorList&& errorList,
+                           std::chrono::steady_clock::duration compileTime)
 {
-    _resourceLists.write([&](auto& rl) {
-        auto& listStatus = rl.at(size_t(type));
+    auto errors = std::make_shared<const ErrorList>(std::move(errorList));
+
+    writeResourceList(type, [&](auto& listStatus) {
+        modifyResource(listStatus.resources.at(index), [&](auto& rs) {
+            rs.compileId = getNextCompileId();
+            rs.state = state;
+            rs.errorList = std::move(errors);
+            rs.compileTime = compileTime;
+        });
+    });
+}
 
-        auto& rs = listStatus.resources.at(index);
-        rs.compileId = getNextCompileId();
-        rs.state = state;
-        rs.errorList = std::move(errorList);
+void CompilerStatus::store(const ResourceType type, std::vector<CompiledResource>&& resources)
+{
+    writeResourceList(type, [&](auto& listStatus) {
+        for (auto& r : resources) {
+            auto errors = std::make_shared<const ErrorList>(std::move(r.errorList));
+
+            modifyResource(listStatus.resources.at(r.index), [&](auto& rs) {
+                rs.compileId = getNextCompileId();
+                rs.state = r.state;
+                rs.errorList = std::move(errors);
+                rs.compileTime = r.compileTime;
+            });
+        }
     });
 }
 
 void CompilerStatus::dependencyErrorOnList(const ResourceType type)
 {
-    _resourceLists.write([&](auto& rl) {
-        const auto cid = getNextCompileId();
+    const auto blankErrorList = std::make_shared<const ErrorList>();
 
-        auto& listData = rl.at(size_t(type));
+    writeResourceList(type, [&](auto& listData) {
+        const auto cid = getNextCompileId();
 
         listData.state = ResourceState::DependencyError;
-        for (auto& rs : listData.resources) {
-            rs.compileId = cid;
-            rs.state = ResourceState::DependencyError;
-            rs.errorList = ErrorList();
+        for (auto& entry : listData.resources) {
+            modifyResource(entry, [&](auto& rs) {
+                rs.compileId = cid;
+                rs.state = ResourceState::DependencyError;
+                rs.errorList = blankErrorList;
+                rs.compileTime = {};
+            });
         }
     });
 }
 
 ResourceState CompilerStatus::getState(const ResourceType type) const
 {
-    return _resourceLists.read_and_return_enum<ResourceState>([&](const auto& rl) {
-        return rl.at(size_t(type)).state;
-    });
+    return snapshot()->at(type).state;
 }
 
 ResourceState CompilerStatus::getState(const ResourceType type, const size_t index) const
 {
-    return _resourceLists.read_and_return_enum<ResourceState>([&](const auto& rl) {
-        auto& listStatus = rl.at(size_t(type));
-        return listStatus.resources.at(index).state;
-    });
+    return snapshot()->at(type).resources.at(index)->state;
 }
 
 uint64_t CompilerStatus::getCompileId(const ProjectSettingsIndex index) const
 {
-    return _resourceLists.read_and_return_uint64_t([&](const auto& rl) {
-        auto& listStatus = rl.at(size_t(ResourceType::ProjectSettings));
-        return listStatus.resources.at(size_t(index)).compileId;
-    });
+    return snapshot()->at(ResourceType::ProjectSettings).resources.at(size_t(index))->compileId;
 }
 
 }
@@ -10,7 +10,10 @@
 #include "models/common/mutex_wrapper.h"
 #include "models/enums.h"
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace UnTech::Project {
@@ -30,6 +33,10 @@ enum class ResourceState {
 };
 
 // This class is thread safe
+//
+// The resource lists are modified by the compiler thread (under a lock).
+// After every modification an immutable `Snapshot` of the lists is published,
+// allowing the GUI to read the status without locking.
 class CompilerStatus {
 public:
     struct ResourceStatus {
@@ -39,7 +46,12 @@ public:
         uint64_t compileId;
 
         ResourceState state = ResourceState::Unchecked;
-        ErrorList errorList{};
+
+        // Shared with the published snapshots, never null.
+        std::shared_ptr<const ErrorList> errorList = std::make_shared<const ErrorList>();
+
+        // Time taken to compile the resource
+        std::chrono::steady_clock::duration compileTime{};
     };
 
     struct ListData {
@@ -47,22 +59,56 @@ public:
         const std::u8string typeNamePlural;
 
         ResourceState state;
-        std::vector<ResourceStatus> resources;
+
+        // The entries are immutable and shared with the published snapshots.
+        // A modified entry is replaced with a new `ResourceStatus`.
+        std::vector<std::shared_ptr<const ResourceStatus>> resources;
 
         ListData(std::u8string tnSingle, std::u8string tnPlural);
     };
 
-    struct Data {
+    struct CompiledResource {
+        size_t index;
+        ResourceState state;
+        ErrorList errorList;
+        std::chrono::steady_clock::duration compileTime;
+    };
+
+    // An immutable copy of the resource lists.
+    // Lists and resources that have not changed are shared between snapshots.
+    struct Snapshot {
+        // Changes every time the name, state or errors of a resource is modified.
+        uint64_t statusId;
+
+        std::array<std::shared_ptr<const ListData>, N_RESOURCE_TYPES> lists;
+
+        [[nodiscard]] const ListData& at(const ResourceType type) const { return *lists.at(size_t(type)); }
     };
 
 private:
     // All fields in this class must be thread safe.
     shared_mutex<std::array<ListData, N_RESOURCE_TYPES>> _resourceLists;
 
+    // Only replaced when `_resourceLists` is locked for writing.
+    std::atomic<std::shared_ptr<const Snapshot>> _snapshot;
+
+private:
+    // Publishes the lists modified by `f`.
+    template <typename Function>
+    void writeResourceLists(Function f);
+
+    // Only publishes the `type` list (for functions that only modify a single list).
+    template <typename Function>
+    void writeResourceList(const ResourceType type, Function f);
+
+    // MUST be called when `_resourceLists` is locked for writing.
+    void publish(const std::array<ListData, N_RESOURCE_TYPES>& rl, std::optional<ResourceType> type);
+
 public:
     explicit CompilerStatus(const ProjectFile& project);
 
-    const auto& resourceLists() const { return _resourceLists; }
+    // Lock free, safe to call multiple times per frame.
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const { return _snapshot.load(std::memory_order_acquire); }
 
     // MUST be called when an resource list is resized or reordered.
     // Will also recompile all resources
@@ -71,7 +117,15 @@ public:
     void markAllUnchecked();
     void markUnchecked(const ResourceType type, const size_t index, const ProjectFile& pf);
 
-    void store(const ResourceType type, const size_t index, ResourceState state, ErrorList&& errorList);
+    // Called by `compileResources()` after an `AllUnchecked` list's DataStore has been cleared and resized.
+    void dataStoreResized(const ResourceType type);
+
+    void store(const ResourceType type, const size_t index, ResourceState state, ErrorList&& errorList,
+               std::chrono::steady_clock::duration compileTime);
+
+    // Stores multiple resources of the same list, only publishing the list once.
+    void store(const ResourceType type, std::vector<CompiledResource>&& resources);
+
     void dependencyErrorOnList(const ResourceType type);
 
     bool updateResourceListState(const ResourceType type);
@@ -85,13 +139,13 @@ public:
     inline void readResourceState(const ResourceType type, const size_t index, Function f) const
         requires std::is_invocable_v<Function, const ResourceStatus&>
     {
-        _resourceLists.read([&](const auto& rl) {
-            auto& ld = rl.at(size_t(type));
-            if (index < ld.resources.size()) {
-                const ResourceStatus& rs = ld.resources.at(index);
-                f(rs);
-            }
-        });
+        const auto s = snapshot();
+
+        const auto& ld = s->at(type);
+        if (index < ld.resources.size()) {
+            const ResourceStatus& rs = *ld.resources.at(index);
+            f(rs);
+        }
     }
 };
 
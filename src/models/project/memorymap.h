@@ -28,6 +28,13 @@ struct MemoryMapSettings {
         return mode == MappingMode::HIROM ? a : a + 0x8000;
     }
 
+    // Location of the bank in the sfc file
+    [[nodiscard]] unsigned bankFileOffset(const unsigned bankNumber) const
+    {
+        const unsigned bank = firstBank + bankNumber;
+        return mode == MappingMode::HIROM ? (bank & 0x3f) * 0x10000 : (bank & 0x7f) * 0x8000;
+    }
+
     bool operator==(const MemoryMapSettings&) const = default;
 };
 
@@ -10,6 +10,7 @@
 #include "rom-data-writer.hpp"
 #include "version.h"
 #include "models/common/iterators.h"
+#include "models/common/profiler.h"
 #include "models/metasprite/compiler/compiler.h"
 #include "models/metasprite/compiler/framesetcompiler.h"
 #include "models/metasprite/compiler/references.h"
@@ -19,6 +20,54 @@
 
 namespace UnTech::Project {
 
+static std::u8string metaSpriteDmaReport(const ProjectFile& input,
+                                         const DataStore<UnTech::MetaSprite::Compiler::FrameSetData>& fsData)
+{
+    StringStream out;
+
+    out.write(u8"frameSet,animation,animationFrame,frame,tiles,bytes,transfers\n");
+
+    for (const auto i : range(fsData.size())) {
+        const auto fs = fsData.at(i);
+        assert(fs);
+        MetaSprite::Compiler::writeDmaReport(out, input.frameSets.at(i), *fs, input);
+    }
+
+    return out.takeString();
+}
+
+static std::vector<std::vector<uint8_t>> exportRoomData(const DataStore<Rooms::RoomData>& rooms)
+{
+    std::vector<std::vector<uint8_t>> out;
+    out.reserve(rooms.size());
+
+    for (const auto i : range(rooms.size())) {
+        const auto room = rooms.at(i);
+        assert(room);
+        out.push_back(room->exportSnesData());
+    }
+
+    return out;
+}
+
+static std::u8string roomSizeReport(const ProjectFile& input, const DataStore<Rooms::RoomData>& rooms,
+                                    const std::vector<std::vector<uint8_t>>& snesData)
+{
+    StringStream out;
+
+    out.write(u8"room,mapWidth,mapHeight,roomDataBytes,mapBlocks,romBytes,largestDecompression\n");
+
+    assert(rooms.size() == snesData.size());
+    for (const auto i : range(rooms.size())) {
+        const auto room = rooms.at(i);
+        const auto roomInput = input.rooms.at(i);
+        assert(room && roomInput);
+        Rooms::writeSizeReport(out, *roomInput, Rooms::roomSizeReport(*room, snesData.at(i)));
+    }
+
+    return out.takeString();
+}
+
 static void writeMetaSpriteData(RomDataWriter& writer,
                                 const Project::MemoryMapSettings& memoryMap,
                                 const DataStore<UnTech::MetaSprite::Compiler::FrameSetData>& fsData)
@@ -78,12 +127,12 @@ static void writeIncList(StringStream& incData, const std::u8string& typeName, c
 {
     incData.write(u8"\nnamespace ", typeName, u8" {\n");
 
-    status.resourceLists().read([&](const auto& rl) {
-        for (auto [id, s] : const_enumerate(rl.at(size_t(rt)).resources)) {
-            assert(s.state == ResourceState::Valid);
-            incData.write(u8"  constant ", s.name, u8" = ", id, u8"\n");
-        }
-    });
+    const auto snapshot = status.snapshot();
+
+    for (auto [id, s] : const_enumerate(snapshot->at(rt).resources)) {
+        assert(s->state == ResourceState::Valid);
+        incData.write(u8"  constant ", s->name, u8" = ", id, u8"\n");
+    }
 
     incData.write(u8"}\n"
                   u8"\n");
@@ -91,22 +140,24 @@ static void writeIncList(StringStream& incData, const std::u8string& typeName, c
 
 static void printErrors(const CompilerStatus& status, StringStream& errorStream)
 {
-    status.resourceLists().read([&](const auto& rl) {
-        for (const auto& listData : rl) {
-            for (const auto& re : listData.resources) {
-                if (!re.errorList.empty()) {
-                    errorStream.write(listData.typeNameSingle, u8" `", re.name, u8"`:\n");
-                    re.errorList.printIndented(errorStream);
-                }
+    const auto snapshot = status.snapshot();
+
+    for (const auto& listData : snapshot->lists) {
+        for (const auto& re : listData->resources) {
+            if (!re->errorList->empty()) {
+                errorStream.write(listData->typeNameSingle, u8" `", re->name, u8"`:\n");
+                re->errorList->printIndented(errorStream);
             }
         }
-    });
+    }
 };
 
 std::unique_ptr<ProjectOutput>
 compileProject(const ProjectFile& input, const std::filesystem::path& relativeBinFilename,
-               StringStream& errorStream)
+               StringStream& errorStream, const ProjectCompilerOptions& options)
 {
+    const Profiler::ScopedSpan span(u8"compileProject");
+
     ProjectData projectData;
     CompilerStatus status(input);
 
@@ -131,6 +182,7 @@ compileProject(const ProjectFile& input, const std::filesystem::path& relativeBi
         { u8"Room.ROOM_FORMAT_VERSION", Rooms::RoomData::ROOM_FORMAT_VERSION },
         { u8"Scripting.GAME_STATE_FORMAT_VERSION", Scripting::GameStateData::GAME_STATE_FORMAT_VERSION },
         { u8"Project.ROOM_DATA_SIZE", input.projectSettings.roomSettings.roomDataSize },
+        { u8"Project.ROOM_MAP_BLOCK_WIDTH", input.projectSettings.roomSettings.mapBlockWidth },
         { u8"Project.MS_FrameSetListCount", unsigned(input.frameSets.size()) },
     };
 
@@ -157,7 +209,9 @@ compileProject(const ProjectFile& input, const std::filesystem::path& relativeBi
     writer.addDataStore(u8"Project.PaletteList", projectData.palettes);
     writer.addDataStore(u8"Project.BackgroundImageList", projectData.backgroundImages);
     writer.addDataStore(u8"Project.MetaTileTilesetList", projectData.metaTileTilesets);
-    writer.addDataStore(u8"Project.RoomList", projectData.rooms);
+
+    const std::vector<std::vector<uint8_t>> roomSnesData = exportRoomData(projectData.rooms);
+    writer.addDataList(u8"Project.RoomList", roomSnesData);
 
     // The inc file is large: increase StringStream buffer size.
     StringStream incData(64 * 1024);
@@ -185,6 +239,17 @@ compileProject(const ProjectFile& input, const std::filesystem::path& relativeBi
     auto ret = std::make_unique<ProjectOutput>();
     ret->incData = incData.takeString();
     ret->binaryData = writer.writeBinaryData();
+    for (const auto [bankId, bank] : const_enumerate(writer.romBanks())) {
+        if (!bank.empty()) {
+            ret->binaryBanks.push_back({ unsigned(bankId), unsigned(bank.data().size()) });
+        }
+    }
+    if (options.metaSpriteDmaReport) {
+        ret->metaSpriteDmaReport = metaSpriteDmaReport(input, projectData.frameSets);
+    }
+    if (options.roomSizeReport) {
+        ret->roomSizeReport = roomSizeReport(input, projectData.rooms, roomSnesData);
+    }
 
     return ret;
 }
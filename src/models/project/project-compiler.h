@@ -8,6 +8,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace UnTech {
@@ -19,12 +20,33 @@ namespace UnTech::Project {
 struct ProjectFile;
 
 struct ProjectOutput {
+    struct BinaryBank {
+        unsigned bankId;
+        unsigned size;
+    };
+
     std::u8string incData;
     std::vector<uint8_t> binaryData;
+
+    // The memory map bank and size of each block of data in `binaryData` (in order)
+    std::vector<BinaryBank> binaryBanks;
+
+    // Estimated DMA cost of the MetaSprite animation frames (CSV)
+    // Empty unless requested in `ProjectCompilerOptions`.
+    std::u8string metaSpriteDmaReport;
+
+    // RAM and ROM usage of each room (CSV)
+    // Empty unless requested in `ProjectCompilerOptions`.
+    std::u8string roomSizeReport;
+};
+
+struct ProjectCompilerOptions {
+    bool metaSpriteDmaReport = false;
+    bool roomSizeReport = false;
 };
 
 // may raise an exception
 std::unique_ptr<ProjectOutput>
 compileProject(const ProjectFile& input, const std::filesystem::path& relativeBinFilename,
-               StringStream& errorStream);
+               StringStream& errorStream, const ProjectCompilerOptions& options = {});
 }
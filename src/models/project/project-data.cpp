@@ -11,6 +11,13 @@ namespace UnTech::Project {
 // DataStore
 // =========
 
+template <typename T>
+DataStore<T>::DataStore()
+    : data()
+    , _snapshot(std::make_shared<const Snapshot>())
+{
+}
+
 template <typename T>
 void DataStore<T>::clearAllAndResize(size_t size)
 {
@@ -20,6 +27,8 @@ void DataStore<T>::clearAllAndResize(size_t size)
 
         d.data.clear();
         d.data.resize(size);
+
+        d.mappingChanged = true;
     });
 }
 
@@ -36,6 +45,7 @@ bool DataStore<T>::store(const size_t index, const idstring& name, std::shared_p
                 // Only remove old name if it points to the correct resource
                 if (it->second == index) {
                     d.mapping.erase(it);
+                    d.mappingChanged = true;
                 }
             }
         }
@@ -45,7 +55,8 @@ bool DataStore<T>::store(const size_t index, const idstring& name, std::shared_p
 
         // Return false if name already used by a resource that is not `index`.
         if (name.isValid()) {
-            const auto [it, b] = d.mapping.try_emplace(name, index);
+            const auto [it, inserted] = d.mapping.try_emplace(name, index);
+            d.mappingChanged |= inserted;
             return it->second == index;
         }
         else {
@@ -54,6 +65,34 @@ bool DataStore<T>::store(const size_t index, const idstring& name, std::shared_p
     });
 }
 
+template <typename T>
+void DataStore<T>::publish()
+{
+    data.write([&](auto& d) {
+        // Only `publish()` replaces `_snapshot` and it is called with `data` locked.
+        const auto old = _snapshot.load(std::memory_order_relaxed);
+
+        auto s = std::make_shared<Snapshot>();
+
+        if (d.mappingChanged || old->mapping == nullptr) {
+            s->mapping = std::make_shared<const std::unordered_map<idstring, size_t>>(d.mapping);
+            d.mappingChanged = false;
+        }
+        else {
+            s->mapping = old->mapping;
+        }
+
+        s->data.reserve(d.data.size());
+        for (const auto& p : d.data) {
+            s->data.push_back(p.second);
+        }
+
+        s->version = old->version + 1;
+
+        _snapshot.store(std::move(s), std::memory_order_release);
+    });
+}
+
 template <typename T>
 size_t DataStore<T>::size() const
 {
@@ -61,33 +100,33 @@ size_t DataStore<T>::size() const
 }
 
 template <typename T>
-std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> DataStore<T>::indexAndDataFor(const idstring& id) const
-{
-    return data.template read_and_return_index_and_const_shared_ptr<T>([&](const auto& d) -> std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> {
-        const auto it = d.mapping.find(id);
-        if (it != d.mapping.end()) {
-            const size_t index = it->second;
-            if (index < d.data.size()) {
-                if (const std::shared_ptr<const T>& p = d.data.at(index).second) {
-                    return std::pair{ index, p };
-                }
+std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> DataStore<T>::Snapshot::indexAndDataFor(const idstring& id) const
+{
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+
+    const auto it = mapping->find(id);
+    if (it != mapping->end()) {
+        const size_t index = it->second;
+        if (index < data.size()) {
+            if (const std::shared_ptr<const T>& p = data.at(index)) {
+                return std::pair{ index, p };
             }
         }
-        return std::nullopt;
-    });
+    }
+    return std::nullopt;
 }
 
 template <typename T>
-std::shared_ptr<const T> DataStore<T>::at(unsigned index) const
-{
-    return data.template read_and_return_const_shared_ptr<T>([&](const auto& d) -> std::shared_ptr<const T> {
-        if (index < d.data.size()) {
-            return d.data.at(index).second;
-        }
-        else {
-            return nullptr;
-        }
-    });
+std::shared_ptr<const T> DataStore<T>::Snapshot::at(unsigned index) const
+{
+    if (index < data.size()) {
+        return data.at(index);
+    }
+    else {
+        return nullptr;
+    }
 }
 
 template class DataStore<UnTech::MetaSprite::Compiler::FrameSetData>;
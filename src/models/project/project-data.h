@@ -8,8 +8,10 @@
 
 #include "models/common/idstring.h"
 #include "models/common/mutex_wrapper.h"
+#include <atomic>
 #include <gsl/pointers>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -57,25 +59,62 @@ namespace UnTech::Project {
 struct ProjectFile;
 
 // This class is thread safe
+//
+// `store()` and `clearAllAndResize()` modify a private copy of the data.
+// The changes are not visible to readers until `publish()` is called, which
+// replaces the immutable `Snapshot` used by `at()` and `indexAndDataFor()`.
 template <typename T>
 class DataStore final {
+public:
+    struct Snapshot {
+        // Shared with the previous snapshot if no names have changed.
+        std::shared_ptr<const std::unordered_map<idstring, size_t>> mapping;
+
+        std::vector<std::shared_ptr<const T>> data;
+
+        // Incremented on every `publish()`
+        uint64_t version = 0;
+
+        // May return nullptr
+        [[nodiscard]] std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> indexAndDataFor(const idstring& id) const;
+        [[nodiscard]] std::shared_ptr<const T> at(unsigned index) const;
+    };
+
+private:
     struct Data {
         std::unordered_map<idstring, size_t> mapping;
         std::vector<std::pair<idstring, std::shared_ptr<const T>>> data;
+
+        bool mappingChanged = true;
     };
     shared_mutex<Data> data;
 
+    std::atomic<std::shared_ptr<const Snapshot>> _snapshot;
+
 public:
+    DataStore();
+
     void clearAllAndResize(size_t size);
 
     // Returns true if name is unique
     [[nodiscard]] bool store(const size_t index, const idstring& name, std::shared_ptr<const T>&& res_data);
 
+    // Makes the stored data visible to readers.
+    void publish();
+
+    // Size of the unpublished data
     [[nodiscard]] size_t size() const;
 
+    // Lock free.
+    // Readers that access multiple resources should use a single snapshot.
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const { return _snapshot.load(std::memory_order_acquire); }
+
     // May return nullptr
-    [[nodiscard]] std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> indexAndDataFor(const idstring& id) const;
-    [[nodiscard]] std::shared_ptr<const T> at(unsigned index) const;
+    [[nodiscard]] std::optional<std::pair<size_t, gsl::not_null<std::shared_ptr<const T>>>> indexAndDataFor(const idstring& id) const
+    {
+        return snapshot()->indexAndDataFor(id);
+    }
+    [[nodiscard]] std::shared_ptr<const T> at(unsigned index) const { return snapshot()->at(index); }
 };
 
 // This class is thread safe
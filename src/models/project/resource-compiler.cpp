@@ -10,6 +10,7 @@
 #include "project.h"
 #include "models/common/externalfilelist.h"
 #include "models/common/optional_ref.h"
+#include "models/common/profiler.h"
 #include "models/common/u8strings.h"
 #include "models/metasprite/compiler/framesetcompiler.h"
 #include <stdexcept>
@@ -23,6 +24,26 @@ using PSI = ProjectSettingsIndex;
 
 static const idstring BLANK_IDSTRING{};
 
+// Profiler span names
+static constexpr std::array<std::u8string_view, N_RESOURCE_TYPES> RESOURCE_SPAN_NAMES{
+    u8"ProjectSettings",
+    u8"FrameSetExportOrder",
+    u8"FrameSet",
+    u8"Palette",
+    u8"BackgroundImage",
+    u8"MetaTileTileset",
+    u8"Room",
+};
+static constexpr std::array<std::u8string_view, N_PROJECT_SETTING_ITEMS> PROJECT_SETTINGS_SPAN_NAMES{
+    u8"ProjectSettings",
+    u8"GameState",
+    u8"Bytecode",
+    u8"InteractiveTiles",
+    u8"ActionPoints",
+    u8"EntityRomData",
+    u8"Scenes",
+};
+
 template <typename T>
 static inline optional_ref<const T&> getItem(const NamedList<T>& list, const size_t index)
 {
@@ -98,6 +119,9 @@ static inline bool validatePs(CompilerStatus& status, const PSI psIndex,
 
     const auto oldState = status.getState(RT::ProjectSettings, index);
     if (isUnchecked(oldState)) {
+        const Profiler::ScopedSpan span(PROJECT_SETTINGS_SPAN_NAMES.at(index));
+        const auto startTime = Profiler::Clock::now();
+
         bool valid = false;
         ErrorList errorList;
 
@@ -119,7 +143,7 @@ static inline bool validatePs(CompilerStatus& status, const PSI psIndex,
         // cppcheck-suppress knownConditionTrueFalse
         const ResourceState state = valid ? ResourceState::Valid : ResourceState::Invalid;
 
-        status.store(RT::ProjectSettings, index, state, std::move(errorList));
+        status.store(RT::ProjectSettings, index, state, std::move(errorList), Profiler::Clock::now() - startTime);
 
         return valid;
     }
@@ -139,6 +163,9 @@ static inline bool compilePs(CompilerStatus& status, const PSI psIndex,
 
     const auto oldState = status.getState(RT::ProjectSettings, index);
     if (isUnchecked(oldState)) {
+        const Profiler::ScopedSpan span(PROJECT_SETTINGS_SPAN_NAMES.at(index));
+        const auto startTime = Profiler::Clock::now();
+
         ResultT data{ nullptr };
         ErrorList errorList;
 
@@ -159,7 +186,7 @@ static inline bool compilePs(CompilerStatus& status, const PSI psIndex,
         const bool valid = data != nullptr;
         const ResourceState state = valid ? ResourceState::Valid : ResourceState::Invalid;
 
-        status.store(RT::ProjectSettings, index, state, std::move(errorList));
+        status.store(RT::ProjectSettings, index, state, std::move(errorList), Profiler::Clock::now() - startTime);
         dataStore.store(std::move(data));
 
         return valid;
@@ -208,6 +235,9 @@ static inline bool validateList(CompilerStatus& status, const RT type,
             }();
 
             if (isUnchecked(status.getState(type, index))) {
+                const Profiler::ScopedSpan span(RESOURCE_SPAN_NAMES.at(size_t(type)), item ? getItemName(*item).str() : std::u8string_view{});
+                const auto startTime = Profiler::Clock::now();
+
                 ResourceState state = ResourceState::Unchecked;
                 ErrorList errorList;
 
@@ -230,7 +260,7 @@ static inline bool validateList(CompilerStatus& status, const RT type,
                     state = ResourceState::Missing;
                 }
 
-                status.store(type, index, state, std::move(errorList));
+                status.store(type, index, state, std::move(errorList), Profiler::Clock::now() - startTime);
             }
         }
 
@@ -241,17 +271,92 @@ static inline bool validateList(CompilerStatus& status, const RT type,
     }
 }
 
+// The compiled data is stored in `dataStore` but is not published.
+template <typename Function, typename ListT, typename T, typename... Args>
+[[nodiscard]] static inline CompilerStatus::CompiledResource
+compileListItem(const RT type, DataStore<T>& dataStore, const size_t index,
+                Function compileFunction, const ListT& list, const Args&... args)
+{
+    const auto item = getItem(list, index);
+
+    const Profiler::ScopedSpan span(RESOURCE_SPAN_NAMES.at(size_t(type)), item ? getItemName(*item).str() : std::u8string_view{});
+    const auto startTime = Profiler::Clock::now();
+
+    std::shared_ptr<const T> data{ nullptr };
+    ResourceState state = ResourceState::Unchecked;
+    ErrorList errorList;
+
+    if (item) {
+        const idstring& itemName = getItemName(*item);
+
+        try {
+            data = compileFunction(*item, expandArg(args)..., errorList);
+
+            // cppcheck-suppress knownConditionTrueFalse
+            state = data != nullptr ? ResourceState::Valid : ResourceState::Invalid;
+        }
+        catch (const std::exception& ex) {
+            data = nullptr;
+            state = ResourceState::Invalid;
+            errorList.addErrorString(u8"EXCEPTION: ", convert_old_string(ex.what()));
+        }
+
+        const bool nameValid = dataStore.store(index, itemName, std::move(data));
+        if (not nameValid) {
+            state = ResourceState::Invalid;
+            errorList.addErrorString(u8"Duplicate resource name: ", itemName);
+        }
+    }
+    else {
+        state = ResourceState::Missing;
+
+        const bool nameValid = dataStore.store(index, BLANK_IDSTRING, nullptr);
+        (void)nameValid; // always false, no need to check it.
+    }
+
+    return {
+        .index = index,
+        .state = state,
+        .errorList = std::move(errorList),
+        .compileTime = Profiler::Clock::now() - startTime,
+    };
+}
+
+// Publishing a DataStore or a CompilerStatus list is O(n), the compiled items are
+// published in batches to prevent large lists from taking O(n^2) time.
+static constexpr auto LIST_PUBLISH_INTERVAL = std::chrono::milliseconds(50);
+
+template <typename T>
+static void publishCompiledItems(CompilerStatus& status, const RT type, DataStore<T>& dataStore,
+                                 std::vector<CompilerStatus::CompiledResource>& compiled)
+{
+    if (compiled.empty()) {
+        return;
+    }
+
+    // The data MUST be visible before the resource is marked compiled.
+    // (The GUI uses `compileId` to detect changes to the compiled data)
+    dataStore.publish();
+
+    status.store(type, std::move(compiled));
+    compiled.clear();
+}
+
+// Items are compiled one at a time and their state is stored immediately.
+// If `cancelToken` is set, the items that have already been compiled are kept and
+// the next call to `compileList()` will resume with the remaining unchecked items.
 template <typename Function, typename ListT, typename T, typename... Args>
 static inline bool compileList(CompilerStatus& status, const RT type, DataStore<T>& dataStore,
-                               std::atomic_flag& cancelToken,
+                               const std::optional<PriorityResource> priority, std::atomic_flag& cancelToken,
                                Function compileFunction, const ListT& list, const Args&... args)
 {
     const auto oldListState = status.getState(type);
     if (isUnchecked(oldListState)) {
         const bool dependenciesValid = validateArgs(args...);
         if (not dependenciesValid) {
-            status.dependencyErrorOnList(type);
             dataStore.clearAllAndResize(list.size());
+            dataStore.publish();
+            status.dependencyErrorOnList(type);
             return false;
         }
 
@@ -259,53 +364,45 @@ static inline bool compileList(CompilerStatus& status, const RT type, DataStore<
 
         if (oldListState == ResourceState::AllUnchecked) {
             dataStore.clearAllAndResize(listSize);
+            dataStore.publish();
+
+            // Prevents the DataStore from being cleared again if this pass is cancelled.
+            status.dataStoreResized(type);
         }
 
         assert(dataStore.size() == list.size());
 
+        std::vector<CompilerStatus::CompiledResource> compiled;
+
+        // The priority item is published immediately.
+        if (priority && priority->type == type && priority->index < listSize) {
+            if (isUnchecked(status.getState(type, priority->index))) {
+                compiled.push_back(compileListItem(type, dataStore, priority->index, compileFunction, list, args...));
+                publishCompiledItems(status, type, dataStore, compiled);
+            }
+        }
+
+        auto lastPublish = Profiler::Clock::now();
+
         for (const size_t index : range(listSize)) {
             if (cancelToken.test()) {
+                publishCompiledItems(status, type, dataStore, compiled);
                 return false;
             }
 
             if (isUnchecked(status.getState(type, index))) {
-                std::shared_ptr<const T> data{ nullptr };
-                ResourceState state = ResourceState::Unchecked;
-                ErrorList errorList;
+                compiled.push_back(compileListItem(type, dataStore, index, compileFunction, list, args...));
 
-                const auto item = getItem(list, index);
-                if (item) {
-                    const idstring& itemName = getItemName(*item);
-
-                    try {
-                        data = compileFunction(*item, expandArg(args)..., errorList);
-
-                        // cppcheck-suppress knownConditionTrueFalse
-                        state = data != nullptr ? ResourceState::Valid : ResourceState::Invalid;
-                    }
-                    catch (const std::exception& ex) {
-                        data = nullptr;
-                        state = ResourceState::Invalid;
-                        errorList.addErrorString(u8"EXCEPTION: ", convert_old_string(ex.what()));
-                    }
-
-                    const bool nameValid = dataStore.store(index, itemName, std::move(data));
-                    if (not nameValid) {
-                        state = ResourceState::Invalid;
-                        errorList.addErrorString(u8"Duplicate resource name: ", itemName);
-                    }
+                const auto now = Profiler::Clock::now();
+                if (now - lastPublish >= LIST_PUBLISH_INTERVAL) {
+                    publishCompiledItems(status, type, dataStore, compiled);
+                    lastPublish = now;
                 }
-                else {
-                    state = ResourceState::Missing;
-
-                    const bool nameValid = dataStore.store(index, BLANK_IDSTRING, nullptr);
-                    (void)nameValid; // always false, no need to check it.
-                }
-
-                status.store(type, index, state, std::move(errorList));
             }
         }
 
+        publishCompiledItems(status, type, dataStore, compiled);
+
         return status.updateResourceListState(type);
     }
     else {
@@ -313,7 +410,8 @@ static inline bool compileList(CompilerStatus& status, const RT type, DataStore<
     }
 }
 
-bool compileResources_impl(CompilerStatus& status, ProjectData& data, const ProjectFile& project, const bool earlyExit, std::atomic_flag& cancelToken)
+bool compileResources_impl(CompilerStatus& status, ProjectData& data, const ProjectFile& project, const bool earlyExit,
+                           const std::optional<PriorityResource> priority, std::atomic_flag& cancelToken)
 {
     bool valid = true;
 
@@ -338,7 +436,7 @@ bool compileResources_impl(CompilerStatus& status, ProjectData& data, const Proj
 
     valid &= compileList(status, RT::Palettes,
                          data.palettes,
-                         cancelToken,
+                         priority, cancelToken,
                          Resources::convertPalette, project.palettes);
 
     if (cancelToken.test()) {
@@ -363,7 +461,7 @@ bool compileResources_impl(CompilerStatus& status, ProjectData& data, const Proj
 
     valid &= compileList(status, RT::FrameSets,
                          data.frameSets,
-                         cancelToken,
+                         priority, cancelToken,
                          MetaSprite::Compiler::compileFrameSet, project.frameSets, project, data.projectSettingsData.actionPointMapping());
 
     if (cancelToken.test()) {
@@ -372,7 +470,7 @@ bool compileResources_impl(CompilerStatus& status, ProjectData& data, const Proj
 
     valid &= compileList(status, RT::BackgroundImages,
                          data.backgroundImages,
-                         cancelToken,
+                         priority, cancelToken,
                          Resources::convertBackgroundImage, project.backgroundImages, data.palettes);
 
     if (cancelToken.test()) {
@@ -381,7 +479,7 @@ bool compileResources_impl(CompilerStatus& status, ProjectData& data, const Proj
 
     valid &= compileList(status, RT::MataTileTilesets,
                          data.metaTileTilesets,
-                         cancelToken,
+                         priority, cancelToken,
                          MetaTiles::convertTileset, project.metaTileTilesets, data.palettes, data.projectSettingsData.interactiveTiles());
 
     if (cancelToken.test()) {
@@ -422,7 +520,7 @@ bool compileResources_impl(CompilerStatus& status, ProjectData& data, const Proj
 
     valid &= compileList(status, RT::Rooms,
                          data.rooms,
-                         cancelToken,
+                         priority, cancelToken,
                          Rooms::compileRoom,
                          project.rooms, project.rooms, data.projectSettingsData.scenes(), data.projectSettingsData.entityRomData(),
                          project.projectSettings.roomSettings, data.projectSettingsData.gameState(), data.projectSettingsData.bytecodeData(), data.metaTileTilesets);
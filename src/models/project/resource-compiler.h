@@ -8,21 +8,32 @@
 
 #include "compiler-status.h"
 #include "project-data.h"
+#include "models/enums.h"
 #include <atomic>
+#include <optional>
 
 namespace UnTech::Project {
 
-bool compileResources_impl(CompilerStatus& status, ProjectData& data, const ProjectFile& project, const bool earlyExit, std::atomic_flag& cancelToken);
+// A resource that is compiled before the other items in its list.
+// (ie, the resource in the currently open editor)
+struct PriorityResource {
+    ResourceType type;
+    size_t index;
+};
 
-inline bool compileResources(CompilerStatus& status, ProjectData& data, const ProjectFile& pf, std::atomic_flag& cancelToken)
+bool compileResources_impl(CompilerStatus& status, ProjectData& data, const ProjectFile& project, const bool earlyExit,
+                           const std::optional<PriorityResource> priority, std::atomic_flag& cancelToken);
+
+inline bool compileResources(CompilerStatus& status, ProjectData& data, const ProjectFile& pf,
+                             const std::optional<PriorityResource> priority, std::atomic_flag& cancelToken)
 {
-    return compileResources_impl(status, data, pf, false, cancelToken);
+    return compileResources_impl(status, data, pf, false, priority, cancelToken);
 }
 
 inline bool compileResources_earlyExit(CompilerStatus& status, ProjectData& data, const ProjectFile& pf)
 {
     std::atomic_flag cancelToken{};
-    return compileResources_impl(status, data, pf, true, cancelToken);
+    return compileResources_impl(status, data, pf, true, std::nullopt, cancelToken);
 }
 
 }
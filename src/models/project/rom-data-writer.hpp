@@ -10,6 +10,7 @@
 #include "rom-bank-data.h"
 #include "models/common/exceptions.h"
 #include "models/common/iterators.h"
+#include "models/common/profiler.h"
 #include "models/common/string.h"
 #include "models/common/stringbuilder.h"
 #include "models/common/stringstream.h"
@@ -148,6 +149,8 @@ public:
     template <class T>
     void addDataStore(const std::u8string& longAddressTableName, const DataStore<T>& dataStore)
     {
+        const Profiler::ScopedSpan span(u8"RomDataWriter::addDataStore", longAddressTableName);
+
         std::vector<uint8_t> longAddressTable(dataStore.size() * 3);
         auto it = longAddressTable.begin();
 
@@ -168,8 +171,31 @@ public:
         _nameDataCounts.emplace_back(Constant{ longAddressTableName + u8".count", unsigned(dataStore.size()) });
     }
 
+    // Adds all data in the list and creates a long address table pointing to the data
+    void addDataList(const std::u8string& longAddressTableName, const std::vector<std::vector<uint8_t>>& dataList)
+    {
+        std::vector<uint8_t> longAddressTable(dataList.size() * 3);
+        auto it = longAddressTable.begin();
+
+        for (const auto& data : dataList) {
+            const auto addr = addData(data);
+
+            *it++ = addr & 0xff;
+            *it++ = (addr >> 8) & 0xff;
+            *it++ = (addr >> 16) & 0xff;
+        }
+        assert(it == longAddressTable.end());
+
+        assert(dataList.size() < INT_MAX);
+
+        addNamedData(longAddressTableName, longAddressTable);
+        _nameDataCounts.emplace_back(Constant{ longAddressTableName + u8".count", unsigned(dataList.size()) });
+    }
+
     void writeIncData(StringStream& incData, const std::filesystem::path& relativeBinFilename) const
     {
+        const Profiler::ScopedSpan span(u8"RomDataWriter::writeIncData");
+
         const std::u8string rbfString = relativeBinFilename.u8string();
 
         for (const Constant& c : _constants) {
@@ -204,8 +230,12 @@ public:
         incData.write(u8"\n\n");
     }
 
+    [[nodiscard]] const std::vector<RomBankData>& romBanks() const { return _romBanks; }
+
     [[nodiscard]] std::vector<uint8_t> writeBinaryData() const
     {
+        const Profiler::ScopedSpan span(u8"RomDataWriter::writeBinaryData");
+
         std::vector<uint8_t> binData;
         binData.reserve(_bankSize * _romBanks.size());
         for (const RomBankData& bank : _romBanks) {
@@ -6,9 +6,12 @@
 
 #include "animated-tileset.h"
 #include "palette.h"
+#include "models/common/arena.h"
+#include "models/common/attributes.h"
 #include "models/common/bytevectorhelper.h"
 #include "models/common/errorlist.h"
 #include "models/common/imagecache.h"
+#include "models/common/mutex_wrapper.h"
 #include "models/lz4/lz4.h"
 #include "models/project/project-data.h"
 #include "models/snes/animatedtilesetinserter.h"
@@ -17,6 +20,8 @@
 #include "models/snes/tilesetinserter.h"
 #include <algorithm>
 #include <cassert>
+#include <memory_resource>
+#include <unordered_map>
 
 #include "tile-extractor.hpp"
 
@@ -24,33 +29,128 @@ namespace UnTech::Resources {
 
 using Tile8px = Snes::Tile8px;
 
+// All intermediate data is allocated from the conversion's arena
 struct AnimatedTilesetIntermediate {
-    std::vector<std::vector<Tile8px>> animatedTiles; // [tileId][frameId]
-    std::vector<Tile8px> staticTiles;
+    std::pmr::vector<std::pmr::vector<Tile8px>> animatedTiles; // [tileId][frameId]
+    std::pmr::vector<Tile8px> staticTiles;
 
     struct TM {
         bool isAnimated;  // cppcheck-suppress unusedStructMember
         unsigned tile;    // cppcheck-suppress unusedStructMember
         unsigned palette; // cppcheck-suppress unusedStructMember
     };
-    std::vector<TM> tileMap;
+    std::pmr::vector<TM> tileMap;
+
+    explicit AnimatedTilesetIntermediate(std::pmr::memory_resource* arena)
+        : animatedTiles(arena)
+        , staticTiles(arena)
+        , tileMap(arena)
+    {
+    }
+};
+
+// The tiles extracted from a single frame image.
+struct FrameTiles {
+    // Used to confirm a cache hit.
+    // Does not keep the image alive after it has been removed from the ImageCache.
+    std::weak_ptr<const Image> image;
+    std::vector<Snes::SnesColor> palette;
+    Snes::BitDepth bitDepth;
+
+    std::pmr::vector<TileAndPalette> tiles;
+    std::vector<InvalidImageTile> invalidTiles;
+
+    [[nodiscard]] bool matches(const std::shared_ptr<const Image>& img, const std::vector<Snes::SnesColor>& pal, const Snes::BitDepth bd) const
+    {
+        return bitDepth == bd && image.lock() == img && palette == pal;
+    }
 };
 
-static std::vector<std::vector<TileAndPalette>> tilesFromFrameImages(const AnimationFramesInput& input,
-                                                                     const std::vector<Snes::SnesColor>& palette,
-                                                                     ErrorList& err)
+// Extracted frame tiles are cached by ImageCache image and conversion palette.
+//
+// A metatile tileset is recompiled whenever its tileset or palette changes,
+// the cache ensures only the frame images that have changed are re-extracted.
+// The ImageCache returns the same `Image` until the file is reloaded, so the
+// image is identified by its address and never hashed or compared by content.
+//
+// Entries for reloaded (expired) images are removed when a new entry is added.
+// The cache is cleared when it is full.
+constexpr static size_t FRAME_TILES_CACHE_SIZE = 512;
+
+using FrameTilesCache_t = std::unordered_map<size_t, std::shared_ptr<const FrameTiles>>;
+
+static mutex<FrameTilesCache_t>& frameTilesCache()
+{
+    static mutex<FrameTilesCache_t> cache;
+    return cache;
+}
+
+static inline void hashCombine(size_t& seed, const size_t v)
+    __attribute__(IGNORE_UNSIGNED_OVERFLOW_ATTR)
+{
+    // numbers from boost
+    seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static size_t frameTilesKey(const Image* image, const std::vector<Snes::SnesColor>& palette, const Snes::BitDepth bitDepth)
+{
+    size_t seed = std::hash<const Image*>{}(image);
+    hashCombine(seed, Snes::colorsForBitDepth(bitDepth));
+
+    for (const auto& c : palette) {
+        hashCombine(seed, c.data());
+    }
+
+    return seed;
+}
+
+static std::shared_ptr<const FrameTiles> extractFrameTiles(const std::filesystem::path& filename,
+                                                           const std::vector<Snes::SnesColor>& palette,
+                                                           const Snes::BitDepth bitDepth)
 {
-    std::vector<std::vector<TileAndPalette>> frameTiles;
+    auto image = ImageCache::loadPngImage(filename);
+    const size_t key = frameTilesKey(image.get(), palette, bitDepth);
+
+    auto cached = frameTilesCache().access_and_return_const_shared_ptr<FrameTiles>(
+        [&](auto& cache) -> std::shared_ptr<const FrameTiles> {
+            auto it = cache.find(key);
+            return it != cache.end() ? it->second : nullptr;
+        });
+
+    if (cached && cached->matches(image, palette, bitDepth)) {
+        return cached;
+    }
+
+    auto ft = std::make_shared<FrameTiles>();
+    ft->image = image;
+    ft->palette = palette;
+    ft->bitDepth = bitDepth;
+    ft->tiles = tilesFromImage(*image, bitDepth, palette, 0, 8, ft->invalidTiles, std::pmr::get_default_resource());
+
+    frameTilesCache().access([&](auto& cache) {
+        std::erase_if(cache, [](const auto& it) { return it.second->image.expired(); });
+
+        if (cache.size() >= FRAME_TILES_CACHE_SIZE) {
+            cache.clear();
+        }
+        cache.insert_or_assign(key, ft);
+    });
+
+    return ft;
+}
+
+static std::vector<std::shared_ptr<const FrameTiles>> tilesFromFrameImages(const AnimationFramesInput& input,
+                                                                           const std::vector<Snes::SnesColor>& palette,
+                                                                           ErrorList& err)
+{
+    std::vector<std::shared_ptr<const FrameTiles>> frameTiles;
     frameTiles.reserve(input.frameImageFilenames.size());
 
     for (const auto [frameIndex, fn] : const_enumerate(input.frameImageFilenames)) {
-        std::vector<InvalidImageTile> invalidTiles;
+        const auto& ft = frameTiles.emplace_back(extractFrameTiles(fn, palette, input.bitDepth));
 
-        const auto& image = ImageCache::loadPngImage(fn);
-        frameTiles.emplace_back(
-            tilesFromImage(*image, input.bitDepth, palette, 0, 8, invalidTiles));
-
-        if (!invalidTiles.empty()) {
+        if (!ft->invalidTiles.empty()) {
+            auto invalidTiles = ft->invalidTiles;
             err.addError(std::make_unique<InvalidImageError>(std::move(invalidTiles), frameIndex));
         }
     }
@@ -59,53 +159,61 @@ static std::vector<std::vector<TileAndPalette>> tilesFromFrameImages(const Anima
 }
 
 static AnimatedTilesetIntermediate combineFrameTiles(
-    const std::vector<std::vector<TileAndPalette>>& frameTiles, unsigned tileWidth,
-    ErrorList& err)
+    const std::vector<std::shared_ptr<const FrameTiles>>& frameTiles, unsigned tileWidth,
+    std::pmr::memory_resource* arena, ErrorList& err)
 {
     assert(!frameTiles.empty());
-    const unsigned nTiles = frameTiles.front().size();
-    for (const auto& tf : frameTiles) {
-        assert(tf.size() == nTiles);
+    const auto& firstFrame = frameTiles.front()->tiles;
+    const unsigned nTiles = firstFrame.size();
+    for (const auto& ft : frameTiles) {
+        assert(ft->tiles.size() == nTiles);
     }
 
-    auto getTile = [&](unsigned frameId, unsigned tileId) -> const Tile8px& {
-        return frameTiles.at(frameId).at(tileId).tile;
-    };
-    auto getPalette = [&](unsigned frameId, unsigned tileId) -> unsigned {
-        return frameTiles.at(frameId).at(tileId).palette;
-    };
-
     const unsigned nFrames = frameTiles.size();
 
+    // Compare each frame against the first frame, one frame at a time.
+    // Frames that are identical to the first frame are skipped with a single comparison.
+    std::pmr::vector<bool> isAnimated(nTiles, false, arena);
+    std::pmr::vector<bool> paletteChanged(nTiles, false, arena);
+
+    for (const auto frameId : range(1, nFrames)) {
+        const auto& frame = frameTiles.at(frameId)->tiles;
+
+        if (frame == firstFrame) {
+            continue;
+        }
+
+        for (const auto tileId : range(nTiles)) {
+            const TileAndPalette& t = frame[tileId];
+            const TileAndPalette& first = firstFrame[tileId];
+
+            if (t.palette != first.palette) {
+                paletteChanged[tileId] = true;
+            }
+            if (t.tile != first.tile) {
+                isAnimated[tileId] = true;
+            }
+        }
+    }
+
     std::vector<InvalidImageTile> invalidTiles;
 
-    AnimatedTilesetIntermediate ret;
+    AnimatedTilesetIntermediate ret(arena);
     ret.animatedTiles.reserve(64);
     ret.tileMap.resize(nTiles);
 
     for (auto [tileId, tm] : enumerate(ret.tileMap)) {
         const static unsigned TS = Tile8px::TILE_SIZE;
 
-        unsigned palette = getPalette(0, tileId);
-        for (const auto frameId : range(nFrames)) {
-            if (getPalette(frameId, tileId) != palette) {
-                invalidTiles.push_back({ TS, unsigned(tileId % tileWidth) * TS, unsigned(tileId / tileWidth) * TS, InvalidTileReason::NOT_SAME_PALETTE });
-                break;
-            }
-        }
-        tm.palette = palette;
-
-        const Tile8px& firstTile = getTile(0, tileId);
-        bool isAnimated = false;
-        for (const auto frameId : range(nFrames)) {
-            if (getTile(frameId, tileId) != firstTile) {
-                isAnimated = true;
-                break;
-            }
+        if (paletteChanged.at(tileId)) {
+            invalidTiles.push_back({ TS, unsigned(tileId % tileWidth) * TS, unsigned(tileId / tileWidth) * TS, InvalidTileReason::NOT_SAME_PALETTE });
         }
+        tm.palette = firstFrame.at(tileId).palette;
+
+        const Tile8px& firstTile = firstFrame.at(tileId).tile;
 
-        tm.isAnimated = isAnimated;
-        if (isAnimated == false) {
+        tm.isAnimated = isAnimated.at(tileId);
+        if (tm.isAnimated == false) {
             tm.tile = ret.staticTiles.size();
             ret.staticTiles.emplace_back(firstTile);
         }
@@ -115,7 +223,7 @@ static AnimatedTilesetIntermediate combineFrameTiles(
             ret.animatedTiles.emplace_back(nFrames);
 
             for (auto [frameId, aTile] : enumerate(ret.animatedTiles.back())) {
-                aTile = getTile(frameId, tileId);
+                aTile = frameTiles.at(frameId)->tiles.at(tileId).tile;
             }
         }
     }
@@ -127,13 +235,14 @@ static AnimatedTilesetIntermediate combineFrameTiles(
     return ret;
 }
 
-static void buildTilesetAndTilemap(AnimatedTilesetData& aniTileset, const usize& mapSize, const AnimatedTilesetIntermediate& input)
+static void buildTilesetAndTilemap(AnimatedTilesetData& aniTileset, const usize& mapSize, const AnimatedTilesetIntermediate& input,
+                                   std::pmr::memory_resource* arena)
 {
     aniTileset.tileMap = grid<Snes::TilemapEntry>(mapSize);
     assert(aniTileset.tileMap.cellCount() == input.tileMap.size());
 
     {
-        Snes::TilesetInserter8px staticTilesetInserter(aniTileset.staticTiles);
+        Snes::TilesetInserter8px staticTilesetInserter(aniTileset.staticTiles, arena);
         auto tmIt = input.tileMap.begin();
         for (auto& tmEntry : aniTileset.tileMap) {
             const auto& tm = *tmIt++;
@@ -160,7 +269,7 @@ static void buildTilesetAndTilemap(AnimatedTilesetData& aniTileset, const usize&
 
         unsigned aniTileOffset = aniTileset.staticTiles.size();
 
-        Snes::AnimatedTilesetInserter<8> aniTilesetInserter(aniTileset.animatedTiles);
+        Snes::AnimatedTilesetInserter<8> aniTilesetInserter(aniTileset.animatedTiles, arena);
         auto tmIt = input.tileMap.begin();
         for (auto& tmEntry : aniTileset.tileMap) {
             const auto& tm = *tmIt++;
@@ -351,17 +460,19 @@ convertAnimationFrames(const AnimationFramesInput& input,
 
     ret.conversionPaletteIndex = paletteIndexAndData->first;
 
+    CompilerArena arena;
+
     const auto frameTiles = tilesFromFrameImages(input, paletteIndexAndData->second->conversionPalette, err);
     if (initialErrorCount != err.errorCount()) {
         return std::nullopt;
     }
-    const auto tilesetIntermediate = combineFrameTiles(frameTiles, mapSize.width, err);
+    const auto tilesetIntermediate = combineFrameTiles(frameTiles, mapSize.width, &arena, err);
 
     if (input.addTransparentTile) {
         ret.staticTiles.emplace_back();
     }
 
-    buildTilesetAndTilemap(ret, mapSize, tilesetIntermediate);
+    buildTilesetAndTilemap(ret, mapSize, tilesetIntermediate, &arena);
 
     if (initialErrorCount != err.errorCount()) {
         return std::nullopt;
@@ -5,6 +5,7 @@
  */
 
 #include "background-image.h"
+#include "models/common/arena.h"
 #include "models/common/bytevectorhelper.h"
 #include "models/common/errorlist.h"
 #include "models/common/imagecache.h"
@@ -14,6 +15,7 @@
 #include "models/snes/tilesetinserter.h"
 #include <algorithm>
 #include <cassert>
+#include <memory_resource>
 
 #include "tile-extractor.hpp"
 
@@ -95,10 +97,12 @@ convertBackgroundImage(const BackgroundImageInput& input, const Project::DataSto
         return nullptr;
     }
 
+    CompilerArena arena;
+
     std::vector<InvalidImageTile> invalidTiles;
-    std::vector<TileAndPalette> extractedTiles = tilesFromImage(*image, input.bitDepth,
-                                                                palette, input.firstPalette, input.nPalettes,
-                                                                invalidTiles);
+    const std::pmr::vector<TileAndPalette> extractedTiles = tilesFromImage(*image, input.bitDepth,
+                                                                           palette, input.firstPalette, input.nPalettes,
+                                                                           invalidTiles, &arena);
     if (!invalidTiles.empty()) {
         err.addError(std::make_unique<InvalidImageError>(std::move(invalidTiles)));
         return nullptr;
@@ -109,13 +113,13 @@ convertBackgroundImage(const BackgroundImageInput& input, const Project::DataSto
     ret->bitDepth = input.bitDepth;
     ret->conversionPaletteIndex = paletteIndexAndData->first;
 
-    Snes::TilesetInserter8px staticTilesetInserter(ret->tiles);
+    Snes::TilesetInserter8px staticTilesetInserter(ret->tiles, &arena);
 
     const usize mapSize(image->size().width / 8, image->size().height / 8);
     ret->tileMap = grid<Snes::TilemapEntry>(mapSize);
 
     auto tmIt = ret->tileMap.begin();
-    for (auto& ex : extractedTiles) {
+    for (const auto& ex : extractedTiles) {
         auto& tm = *tmIt++;
 
         const auto to = staticTilesetInserter.getOrInsert(ex.tile);
@@ -199,16 +203,15 @@ static void convertBackgroundMap(std::vector<uint8_t>& out, const grid<Snes::Til
     const unsigned endX = std::min<unsigned>(BG_MAP_WIDTH, grid.width() - xOffset);
     const unsigned endY = std::min<unsigned>(BG_MAP_HEIGHT, grid.height() - yOffset);
 
-    auto it = out.begin() + startIndex;
     for (const auto y : range(endY)) {
-        for (const auto x : range(endX)) {
-            const auto& tm = grid.at(x + xOffset, y + yOffset);
+        const auto scanline = grid.scanline(y + yOffset).subspan(xOffset, endX);
 
+        auto it = out.begin() + startIndex + y * BG_MAP_WIDTH * 2;
+        for (const auto& tm : scanline) {
             *it++ = tm.data & 0xff;
             *it++ = (tm.data >> 8) & 0xff;
         }
     }
-    assert(it == out.end());
 }
 
 const int BackgroundImageData::BACKGROUND_IMAGE_FORMAT_VERSION = 1;
@@ -227,7 +230,7 @@ std::vector<uint8_t> BackgroundImageData::exportSnesData() const
 
     // tileMaps
     for (unsigned y = 0; y < tileMap.height(); y += 32) {
-        for (unsigned x = 0; x < tileMap.height(); x += 32) {
+        for (unsigned x = 0; x < tileMap.width(); x += 32) {
             convertBackgroundMap(mapAndTileData, tileMap, x, y);
         }
     }
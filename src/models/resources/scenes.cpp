@@ -14,6 +14,7 @@
 #include "models/metatiles/metatile-tileset.h"
 #include "models/project/project-data.h"
 #include "models/snes/bit-depth.h"
+#include <bit>
 #include <numeric>
 
 namespace UnTech::Resources {
@@ -223,88 +224,147 @@ inline SceneLayoutsData::LayerInput::LayerInput(const SceneLayerData& lds)
 
 constexpr unsigned SCENE_LAYOUT_DATA_ENTRY_SIZE = 8;
 
+// A bitmask of VRAM blocks (bit n is block n)
+using VramBlockMask = uint32_t;
+static_assert(SceneLayoutsData::N_VRAM_BLOCKS < sizeof(VramBlockMask) * 8);
+
+constexpr VramBlockMask ALL_VRAM_BLOCKS = (VramBlockMask(1) << SceneLayoutsData::N_VRAM_BLOCKS) - 1;
+
+static constexpr VramBlockMask vramBlockMask(const unsigned start, const unsigned nBlocks)
+{
+    return ((VramBlockMask(1) << nBlocks) - 1) << start;
+}
+
+// Returns a mask of the aligned blocks that start a run of `nBlocks` unused blocks.
+static VramBlockMask freeRunStarts(const VramBlockMask usedBlocks, const unsigned nBlocks, const unsigned align)
+{
+    const VramBlockMask freeBlocks = ~usedBlocks & ALL_VRAM_BLOCKS;
+
+    VramBlockMask starts = freeBlocks;
+    for (const auto i : range(1, nBlocks)) {
+        starts &= freeBlocks >> i;
+    }
+
+    VramBlockMask alignMask = 0;
+    for (unsigned b = 0; b < SceneLayoutsData::N_VRAM_BLOCKS; b += align) {
+        alignMask |= VramBlockMask(1) << b;
+    }
+
+    return starts & alignMask;
+}
+
+struct LayoutBase {
+    unsigned map;
+    unsigned tiles;
+};
+
+struct LayoutItem {
+    unsigned layerId;
+    unsigned nBlocks;
+    bool isMap;
+};
+
+// Backtracking search for a position for every item.
+// Returns false if the items cannot be placed or the search took too many steps.
+static bool placeLayoutItems(const std::span<const LayoutItem> items, const VramBlockMask usedBlocks,
+                             std::array<LayoutBase, N_LAYERS>& bases, unsigned& stepsRemaining)
+{
+    if (items.empty()) {
+        return true;
+    }
+    if (stepsRemaining == 0) {
+        return false;
+    }
+    stepsRemaining--;
+
+    const LayoutItem& item = items.front();
+    const unsigned align = item.isMap ? SceneLayoutsData::MAP_ALIGN : SceneLayoutsData::TILE_ALIGN;
+
+    VramBlockMask starts = freeRunStarts(usedBlocks, item.nBlocks, align);
+
+    while (starts != 0) {
+        // Tiles are placed at the start of VRAM and maps at the end of VRAM
+        // to increase the amount of free tiles available after the tile data.
+        const unsigned b = item.isMap ? std::bit_width(starts) - 1 : std::countr_zero(starts);
+        starts &= ~(VramBlockMask(1) << b);
+
+        if (item.isMap) {
+            bases.at(item.layerId).map = b;
+        }
+        else {
+            bases.at(item.layerId).tiles = b;
+        }
+
+        if (placeLayoutItems(items.subspan(1), usedBlocks | vramBlockMask(b, item.nBlocks), bases, stepsRemaining)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 inline std::optional<uint8_t> SceneLayoutsData::addLayout(const std::array<SceneLayoutsData::LayerInput, N_LAYERS>& input)
 {
     constexpr unsigned UNUSED_BLOCK_ID = UINT8_MAX;
     static_assert(N_VRAM_BLOCKS < UNUSED_BLOCK_ID);
 
-    // Use a First-fit algorithm to fill the VRAM and calculate the base for each layer
+    // Limits the backtracking search on layouts that do not fit
+    constexpr unsigned MAX_SEARCH_STEPS = 4096;
+
+    std::array<LayoutBase, N_LAYERS> layerBases{};
+
+    // Place the largest tiles first, then the largest maps.
     // Returns with std::nullopt if a layout could not be found
-    struct Base {
-        unsigned map;
-        unsigned tiles;
-    };
-    std::array<Base, N_LAYERS> layerBases{};
+    std::vector<LayoutItem> items;
+    items.reserve(N_LAYERS * 2);
 
-    std::array<bool, N_VRAM_BLOCKS> freeBlocks{};
-    freeBlocks.fill(true);
+    unsigned totalBlocks = 0;
 
-    auto findFreeSpaceForwards = [&](const unsigned nBlocks, const unsigned align) -> std::optional<unsigned> {
-        if (nBlocks == 0) {
-            return UNUSED_BLOCK_ID;
-        }
+    for (const auto layerId : range(N_LAYERS)) {
+        const auto& in = input.at(layerId);
 
-        if (nBlocks > freeBlocks.size()) {
+        if (in.nTileBlocks > N_VRAM_BLOCKS || in.nMapBlocks > N_VRAM_BLOCKS) {
             throw runtime_error(u8"nBlocks is too large");
         }
 
-        for (unsigned b = 0; b < freeBlocks.size(); b += align) {
-            auto span = std::span(freeBlocks).subspan(b, nBlocks);
+        layerBases.at(layerId) = { UNUSED_BLOCK_ID, UNUSED_BLOCK_ID };
 
-            unsigned count = std::count(span.begin(), span.end(), true);
-            if (count == nBlocks) {
-                std::fill(span.begin(), span.end(), false);
-                return b;
-            }
+        if (in.nTileBlocks > 0) {
+            items.push_back({ unsigned(layerId), in.nTileBlocks, false });
         }
-        return std::nullopt;
-    };
-
-    auto findFreeSpaceBackwards = [&](const unsigned nBlocks, const unsigned align) -> std::optional<unsigned> {
-        if (nBlocks == 0) {
-            return UNUSED_BLOCK_ID;
+        if (in.nMapBlocks > 0) {
+            items.push_back({ unsigned(layerId), in.nMapBlocks, true });
         }
+        totalBlocks += in.nTileBlocks + in.nMapBlocks;
+    }
 
-        if (nBlocks > freeBlocks.size()) {
-            throw runtime_error(u8"nBlocks is too large");
-        }
+    if (totalBlocks > N_VRAM_BLOCKS) {
+        return std::nullopt;
+    }
 
-        unsigned b = freeBlocks.size() - align;
-        while (b + nBlocks >= freeBlocks.size()) {
-            b -= align;
+    std::stable_sort(items.begin(), items.end(), [](const LayoutItem& a, const LayoutItem& b) {
+        if (a.isMap != b.isMap) {
+            return b.isMap;
         }
+        return a.nBlocks > b.nBlocks;
+    });
 
-        while (b > nBlocks) {
-            auto span = std::span(freeBlocks).subspan(b, nBlocks);
-
-            unsigned count = std::count(span.begin(), span.end(), true);
-            if (count == nBlocks) {
-                std::fill(span.begin(), span.end(), false);
-                return b;
-            }
-
-            b -= nBlocks;
-        }
+    unsigned stepsRemaining = MAX_SEARCH_STEPS;
+    if (!placeLayoutItems(items, 0, layerBases, stepsRemaining)) {
         return std::nullopt;
-    };
-
-    for (const auto layerId : range(N_LAYERS)) {
-        auto b = findFreeSpaceForwards(input.at(layerId).nTileBlocks, TILE_ALIGN);
-        if (!b) {
-            return std::nullopt;
-        }
-        layerBases.at(layerId).tiles = *b;
     }
 
-    // ::TODO sort layers by size of maps (insertation sort)::
-
+    VramBlockMask usedBlocks = 0;
     for (const auto layerId : range(N_LAYERS)) {
-        // Search backwards through vram to increase the amount of free tiles available for BG 1 and BG 2
-        auto b = findFreeSpaceBackwards(input.at(layerId).nTileBlocks, MAP_ALIGN);
-        if (!b) {
-            return std::nullopt;
+        const auto& in = input.at(layerId);
+        const auto& base = layerBases.at(layerId);
+
+        if (base.tiles != UNUSED_BLOCK_ID) {
+            usedBlocks |= vramBlockMask(base.tiles, in.nTileBlocks);
+        }
+        if (base.map != UNUSED_BLOCK_ID) {
+            usedBlocks |= vramBlockMask(base.map, in.nMapBlocks);
         }
-        layerBases.at(layerId).map = *b;
     }
 
     // Create LayerLayout and Scene Layout Data for the calculated bases
@@ -353,10 +413,10 @@ inline std::optional<uint8_t> SceneLayoutsData::addLayout(const std::array<Scene
             assert(base.tiles + nTileBlocks <= N_VRAM_BLOCKS);
 
             // Find amount of free space after the tiles data.
-            auto it = std::find(freeBlocks.begin() + base.tiles + nTileBlocks, freeBlocks.end(), false);
-            if (it != freeBlocks.end()) {
-                const int d = std::distance(freeBlocks.begin(), it);
-                assert(d > 0 && unsigned(d) > base.tiles);
+            const VramBlockMask usedAfter = usedBlocks & ~vramBlockMask(0, base.tiles + nTileBlocks);
+            if (usedAfter != 0) {
+                const unsigned d = std::countr_zero(usedAfter);
+                assert(d > base.tiles);
                 const unsigned newNBlocks = d - base.tiles;
                 assert(newNBlocks >= nTileBlocks);
                 nTileBlocks = newNBlocks;
@@ -394,7 +454,40 @@ inline std::optional<uint8_t> SceneLayoutsData::addLayout(const std::array<Scene
     return layoutId;
 }
 
+static uint64_t layoutInputKey(const std::array<SceneLayoutsData::LayerInput, N_LAYERS>& input)
+{
+    uint64_t key = 0;
+    for (const auto& in : input) {
+        key = (key << 16) | (uint64_t(in.nTileBlocks) << 8) | (uint64_t(in.nMapBlocks) << 2) | (in.mapSizeBits & 3);
+    }
+    return key;
+}
+
 inline std::optional<uint8_t> SceneLayoutsData::findOrAdd(const std::array<SceneLayoutsData::LayerInput, N_LAYERS>& input)
+{
+    static_assert(N_VRAM_BLOCKS < 64);
+    static_assert(N_LAYERS * 16 <= 64);
+
+    const uint64_t key = layoutInputKey(input);
+
+    auto it = _inputMap.find(key);
+    if (it != _inputMap.end()) {
+        return it->second;
+    }
+
+    const auto layoutId = findCompatibleLayout(input);
+    if (layoutId) {
+        _inputMap.emplace(key, *layoutId);
+        return layoutId;
+    }
+
+    // The failure is also cached, an impossible input is only searched for once.
+    const auto newLayoutId = addLayout(input);
+    _inputMap.emplace(key, newLayoutId);
+    return newLayoutId;
+}
+
+inline std::optional<uint8_t> SceneLayoutsData::findCompatibleLayout(const std::array<SceneLayoutsData::LayerInput, N_LAYERS>& input) const
 {
     for (const auto [layoutId, layout] : const_enumerate(_sceneLayouts)) {
         bool match = true;
@@ -408,13 +501,14 @@ inline std::optional<uint8_t> SceneLayoutsData::findOrAdd(const std::array<Scene
         }
     }
 
-    return addLayout(input);
+    return std::nullopt;
 }
 
 inline void SceneLayoutsData::reserve(unsigned cap)
 {
     _sceneLayouts.reserve(cap);
     _sceneLayoutData.reserve(cap);
+    _inputMap.reserve(cap);
 }
 
 // Scene
@@ -141,6 +141,10 @@ private:
     std::vector<uint8_t> _sceneLayoutData;
     std::vector<std::array<LayerLayout, N_LAYERS>> _sceneLayouts;
 
+    // Mapping of `LayerInput` values to layout ids (used to speedup `findOrAdd()`)
+    // nullopt if a layout could not be created for the input.
+    std::unordered_map<uint64_t, std::optional<uint8_t>> _inputMap;
+
 public:
     SceneLayoutsData() = default;
 
@@ -154,6 +158,7 @@ public:
     void reserve(unsigned cap);
 
 private:
+    [[nodiscard]] std::optional<uint8_t> findCompatibleLayout(const std::array<LayerInput, N_LAYERS>& input) const;
     std::optional<uint8_t> addLayout(const std::array<LayerInput, N_LAYERS>& input);
 };
 
@@ -10,6 +10,7 @@
 #include "models/snes/bit-depth.h"
 #include "models/snes/convert-snescolor.h"
 #include "models/snes/tile.h"
+#include <memory_resource>
 #include <vector>
 
 namespace UnTech::Resources {
@@ -17,6 +18,8 @@ namespace UnTech::Resources {
 struct TileAndPalette {
     Snes::Tile8px tile;
     unsigned palette{};
+
+    bool operator==(const TileAndPalette&) const = default;
 };
 
 inline bool extractTile8px(Snes::Tile8px& tile,
@@ -69,10 +72,11 @@ inline bool extractTileAndPalette(TileAndPalette& ft, const Image& image, const
     return false;
 }
 
-inline std::vector<TileAndPalette> tilesFromImage(const Image& image, const Snes::BitDepth bitDepth,
-                                                  const std::vector<Snes::SnesColor>& palette,
-                                                  const unsigned firstPalette, const unsigned nPalettes,
-                                                  std::vector<InvalidImageTile>& err)
+inline std::pmr::vector<TileAndPalette> tilesFromImage(const Image& image, const Snes::BitDepth bitDepth,
+                                                       const std::vector<Snes::SnesColor>& palette,
+                                                       const unsigned firstPalette, const unsigned nPalettes,
+                                                       std::vector<InvalidImageTile>& err,
+                                                       std::pmr::memory_resource* memoryResource)
 {
     const static unsigned TS = decltype(TileAndPalette::tile)::TILE_SIZE;
 
@@ -82,7 +86,7 @@ inline std::vector<TileAndPalette> tilesFromImage(const Image& image, const Snes
 
     unsigned tw = iSize.width / TS;
     unsigned th = iSize.height / TS;
-    std::vector<TileAndPalette> tiles(tw * th);
+    std::pmr::vector<TileAndPalette> tiles(tw * th, memoryResource);
     auto tileIt = tiles.begin();
 
     for (unsigned y = 0; y < iSize.height; y += TS) {
@@ -211,12 +211,19 @@ void saveRoomInput(const RoomInput& input, const std::filesystem::path& filename
 void readRoomSettings(RoomSettings& settings, const XmlTag& tag)
 {
     settings.roomDataSize = tag.getAttributeUnsigned(u8"room-data-size");
+
+    if (tag.hasAttribute(u8"map-block-width")) {
+        settings.mapBlockWidth = tag.getAttributeUnsigned(u8"map-block-width");
+    }
 }
 
 void writeRoomSettings(XmlWriter& xml, const RoomSettings& settings)
 {
     xml.writeTag(u8"room-settings");
     xml.writeTagAttribute(u8"room-data-size", settings.roomDataSize);
+    if (settings.mapBlockWidth != 0) {
+        xml.writeTagAttribute(u8"map-block-width", settings.mapBlockWidth);
+    }
     xml.writeCloseTag();
 }
 
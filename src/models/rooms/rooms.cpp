@@ -6,9 +6,12 @@
 
 #include "rooms.h"
 #include "errorlisthelpers.h"
+#include "models/common/arena.h"
 #include "models/common/errorlist.h"
+#include "models/common/exceptions.h"
 #include "models/common/iterators.h"
 #include "models/common/string.h"
+#include "models/common/stringstream.h"
 #include "models/common/validateunique.h"
 #include "models/entity/entityromdata.h"
 #include "models/lz4/lz4.h"
@@ -18,6 +21,9 @@
 #include "models/resources/scenes.h"
 #include "models/scripting/script-compiler.hpp"
 #include <algorithm>
+#include <bit>
+#include <memory_resource>
+#include <span>
 
 namespace UnTech::Rooms {
 
@@ -59,6 +65,15 @@ bool validate(const RoomSettings& input, ErrorList& err)
 
     validateMinMax(input.roomDataSize, input.MIN_ROOM_DATA_SIZE, input.MAX_ROOM_DATA_SIZE, u8"Max Room Size invalid");
 
+    if (input.mapBlockWidth != 0) {
+        validateMinMax(input.mapBlockWidth, input.MIN_MAP_BLOCK_WIDTH, input.MAX_MAP_BLOCK_WIDTH, u8"Map Block Width invalid");
+
+        if (!std::has_single_bit(input.mapBlockWidth)) {
+            err.addErrorString(u8"Map Block Width must be a power of two (", input.mapBlockWidth, u8")");
+            valid = false;
+        }
+    }
+
     return valid;
 }
 
@@ -264,18 +279,15 @@ static bool isTileAllowedRightofEndSlope(const MetaTiles::TileCollisionType tile
     return false;
 }
 
-static unsigned checkTileCollision_Border(const unsigned x, const unsigned y,
-                                          const grid<uint8_t>& map, const MetaTiles::MetaTileTilesetData& tileset)
+using TileCollisionRow = std::span<const MetaTiles::TileCollisionType>;
+
+static unsigned checkTileCollision_Border(const unsigned x, const TileCollisionRow row)
 {
     unsigned ret = 0;
 
-    auto getTc = [&](unsigned x, unsigned y) {
-        return tileset.tileCollisions.at(map.at(x, y));
-    };
-
     using TCT = MetaTiles::TileCollisionType;
 
-    const TCT tile = getTc(x, y);
+    const TCT tile = row[x];
 
     switch (tile) {
     case TCT::DOWN_RIGHT_SLOPE:
@@ -295,14 +307,14 @@ static unsigned checkTileCollision_Border(const unsigned x, const unsigned y,
 
     case TCT::END_SLOPE:
         if (x > 0) {
-            const TCT left = getTc(x - 1, y);
+            const TCT left = row[x - 1];
 
             if (!isTileAllowedLeftofEndSlope(left)) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_LEFT;
             }
         }
-        if (x < map.width() - 1) {
-            const TCT right = getTc(x + 1, y);
+        if (x < row.size() - 1) {
+            const TCT right = row[x + 1];
 
             if (!isTileAllowedRightofEndSlope(right)) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_RIGHT;
@@ -320,33 +332,37 @@ static unsigned checkTileCollision_Border(const unsigned x, const unsigned y,
     return ret;
 }
 
+// Tiles that do not need to be tested by `checkTileCollision_NotBorder()`
+static constexpr std::array<bool, MetaTiles::N_TILE_COLLISONS> SKIP_TILE_COLLISION_TEST = []() {
+    using TCT = MetaTiles::TileCollisionType;
+
+    std::array<bool, MetaTiles::N_TILE_COLLISONS> a{};
+    a.at(unsigned(TCT::EMPTY)) = true;
+    a.at(unsigned(TCT::SOLID)) = true;
+    a.at(unsigned(TCT::UP_PLATFORM)) = true;
+    a.at(unsigned(TCT::DOWN_PLATFORM)) = true;
+    return a;
+}();
+
 // NOTE: This function MUST NOT be called on a tile along the border of the map grid.
-static unsigned checkTileCollision_NotBorder(const unsigned x, const unsigned y,
-                                             const grid<uint8_t>& map, const MetaTiles::MetaTileTilesetData& tileset)
+// NOTE: This function MUST NOT be called on a `SKIP_TILE_COLLISION_TEST` tile.
+// `above`, `row` and `below` are three consecutive scanlines of the map
+static unsigned checkTileCollision_NotBorder(const unsigned x,
+                                             const TileCollisionRow aboveRow, const TileCollisionRow row, const TileCollisionRow belowRow)
 {
     using TCT = MetaTiles::TileCollisionType;
 
     unsigned ret = 0;
 
-    auto getTc = [&](unsigned x, unsigned y) {
-        return tileset.tileCollisions.at(map.at(x, y));
-    };
+    const TCT tile = row[x];
 
-    const TCT tile = getTc(x, y);
+    assert(!SKIP_TILE_COLLISION_TEST[unsigned(tile)]);
 
-    if (tile == TCT::EMPTY
-        || tile == TCT::SOLID
-        || tile == TCT::UP_PLATFORM
-        || tile == TCT::DOWN_PLATFORM) {
-
-        return 0;
-    }
+    const TCT above = aboveRow[x];
+    const TCT below = belowRow[x];
 
-    const TCT above = getTc(x, y - 1);
-    const TCT below = getTc(x, y + 1);
-
-    const TCT left = getTc(x - 1, y);
-    const TCT right = getTc(x + 1, y);
+    const TCT left = row[x - 1];
+    const TCT right = row[x + 1];
 
     auto testDownSlopeAboveBelow = [&]() {
         // ::TODO add configurable minimum slope spacing::
@@ -371,7 +387,7 @@ static unsigned checkTileCollision_NotBorder(const unsigned x, const unsigned y,
     auto testDownSlopeLeft = [&](const auto... args) {
         if (left == TCT::SOLID) {
             // A SOLID tile is valid if it is a part of a wall
-            const TCT aboveLeft = getTc(x - 1, y - 1);
+            const TCT aboveLeft = aboveRow[x - 1];
             if (aboveLeft != TCT::SOLID) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_LEFT;
             }
@@ -383,7 +399,7 @@ static unsigned checkTileCollision_NotBorder(const unsigned x, const unsigned y,
 
     auto testUpSlopeLeft = [&](const auto... args) {
         if (left == TCT::SOLID) {
-            const TCT belowLeft = getTc(x - 1, y + 1);
+            const TCT belowLeft = belowRow[x - 1];
             if (belowLeft != TCT::SOLID) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_LEFT;
             }
@@ -395,7 +411,7 @@ static unsigned checkTileCollision_NotBorder(const unsigned x, const unsigned y,
 
     auto testDownSlopeRight = [&](const auto... args) {
         if (right == TCT::SOLID) {
-            const TCT aboveRight = getTc(x + 1, y - 1);
+            const TCT aboveRight = aboveRow[x + 1];
             if (aboveRight != TCT::SOLID) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_RIGHT;
             }
@@ -407,7 +423,7 @@ static unsigned checkTileCollision_NotBorder(const unsigned x, const unsigned y,
 
     auto testUpSlopeRight = [&](const auto... args) {
         if (right == TCT::SOLID) {
-            const TCT belowRight = getTc(x + 1, y + 1);
+            const TCT belowRight = belowRow[x + 1];
             if (belowRight != TCT::SOLID) {
                 ret |= InvalidRoomTile::INVALID_TILE_ON_THE_RIGHT;
             }
@@ -515,30 +531,55 @@ static void checkRoomTileCollisions(const grid<uint8_t>& map,
         return;
     }
 
+    using TCT = MetaTiles::TileCollisionType;
+
+    const unsigned width = map.width();
+    const unsigned height = map.height();
+
+    static_assert(MetaTiles::N_METATILES > UINT8_MAX);
+
+    // Convert the map to tile collision types (row-major) once, so the
+    // tests below only access the three scanlines they are testing.
+    std::vector<TCT> collisions(width * height);
+    for (const auto y : range(height)) {
+        const auto mapRow = map.scanline(y);
+        std::transform(mapRow.begin(), mapRow.end(), collisions.begin() + y * width,
+                       [&](const uint8_t t) { return tileset.tileCollisions[t]; });
+    }
+
+    auto scanline = [&](const unsigned y) {
+        return TileCollisionRow(collisions).subspan(y * width, width);
+    };
+
     std::vector<InvalidRoomTile> invalidTiles;
 
-    auto test = [&](auto checkTileCollisionFunction, unsigned x, unsigned y) {
-        const uint8_t d = checkTileCollisionFunction(x, y, map, tileset);
+    auto addInvalidTile = [&](const unsigned x, const unsigned y, const unsigned d) {
         if (d != 0) {
             invalidTiles.emplace_back(x, y, d);
         }
     };
 
     // Top Row
-    for (const auto x : range(map.width())) {
-        test(checkTileCollision_Border, x, 0);
+    for (const auto x : range(width)) {
+        addInvalidTile(x, 0, checkTileCollision_Border(x, scanline(0)));
     }
-    for (const auto y : range(1, map.height() - 1)) {
-        test(checkTileCollision_Border, 0, y);
+    for (const auto y : range(1, height - 1)) {
+        const TileCollisionRow above = scanline(y - 1);
+        const TileCollisionRow row = scanline(y);
+        const TileCollisionRow below = scanline(y + 1);
 
-        for (const auto x : range(1, map.width() - 1)) {
-            test(checkTileCollision_NotBorder, x, y);
+        addInvalidTile(0, y, checkTileCollision_Border(0, row));
+
+        for (const auto x : range(1, width - 1)) {
+            if (!SKIP_TILE_COLLISION_TEST[unsigned(row[x])]) {
+                addInvalidTile(x, y, checkTileCollision_NotBorder(x, above, row, below));
+            }
         }
 
-        test(checkTileCollision_Border, map.width() - 1, y);
+        addInvalidTile(width - 1, y, checkTileCollision_Border(width - 1, row));
     }
-    for (const auto x : range(map.width())) {
-        test(checkTileCollision_Border, x, map.height() - 1);
+    for (const auto x : range(width)) {
+        addInvalidTile(x, height - 1, checkTileCollision_Border(x, scanline(height - 1)));
     }
 
     if (!invalidTiles.empty()) {
@@ -669,10 +710,12 @@ compileRoom(const RoomInput& input, const ExternalFileList<Rooms::RoomInput>& ro
 
     const unsigned totalEntityCount = countEntities(input.entityGroups);
 
+    CompilerArena arena;
+
     // Create mappings
     // To be used by the scripting engine
-    std::unordered_map<idstring, unsigned> entityGroupIndexMap;
-    std::unordered_map<idstring, unsigned> entityNameIndexMap;
+    std::pmr::unordered_map<idstring, unsigned> entityGroupIndexMap(&arena);
+    std::pmr::unordered_map<idstring, unsigned> entityNameIndexMap(&arena);
     {
         entityGroupIndexMap.reserve(input.entityGroups.size());
 
@@ -710,6 +753,8 @@ compileRoom(const RoomInput& input, const ExternalFileList<Rooms::RoomInput>& ro
     const unsigned mapHeight = mapHeightBit ? MAP_HEIGHT_SMALL : MAP_HEIGHT_LARGE;
     const unsigned mapDataSize = mapHeight * input.map.width();
 
+    const bool mapInRoomData = roomSettings.mapBlockWidth == 0;
+
     const unsigned roomEntranceDataSize = 1 + 4 * input.entrances.size();
 
     assert(totalEntityCount < MAX_ENTITY_ENTRIES);
@@ -724,7 +769,7 @@ compileRoom(const RoomInput& input, const ExternalFileList<Rooms::RoomInput>& ro
     // Start of data with known size
     // -----------------------------
 
-    data.resize(HEADER_SIZE + mapDataSize + roomEntranceDataSize + entityDataSize);
+    data.resize(HEADER_SIZE + (mapInRoomData ? mapDataSize : 0) + roomEntranceDataSize + entityDataSize);
     auto it = data.begin();
 
     // Header
@@ -793,22 +838,24 @@ compileRoom(const RoomInput& input, const ExternalFileList<Rooms::RoomInput>& ro
     }
 
     // Map data
-    {
-        const auto begin = it;
+    // (column major, each column is padded to mapHeight)
+    if (mapInRoomData) {
+        input.map.transposeInto(std::span(it, mapDataSize), mapHeight);
+        it += mapDataSize;
+    }
+    else {
+        // Each map block is compressed separately, allowing the map to be
+        // decompressed a few columns at a time as the room scrolls.
+        const unsigned blockWidth = roomSettings.mapBlockWidth;
 
-        for (const auto x : range(input.map.width())) {
-            for (const auto y : range(input.map.height())) {
-                *it++ = input.map.at(x, y);
-            }
-            if (input.map.height() < mapHeight) {
-                it += mapHeight - input.map.height();
-            }
+        for (unsigned x = 0; x < input.map.width(); x += blockWidth) {
+            const unsigned nColumns = std::min<unsigned>(blockWidth, input.map.width() - x);
+
+            auto& block = out->mapBlocks.emplace_back(nColumns * mapHeight, 0);
+            input.map.transposeInto(block, mapHeight, x, nColumns);
         }
-        assert(it == begin + mapDataSize);
     }
 
-    // ::TODO add submaps::
-
     // Room Entrance Data
     {
         assert(input.entrances.size() > 0);
@@ -963,11 +1010,67 @@ compileRoom(const RoomInput& input, const ExternalFileList<Rooms::RoomInput>& ro
     return out;
 }
 
-const int RoomData::ROOM_FORMAT_VERSION = 6;
+const int RoomData::ROOM_FORMAT_VERSION = 7;
 
+// OUTPUT FORMAT (no map blocks):
+//      <lz4 room data>
+//
+// OUTPUT FORMAT (with map blocks):
+//      <uint8 nMapBlocks>
+//      <uint16 map block offsets[nMapBlocks]> (offset from the start of the output)
+//      <lz4 room data>
+//      <lz4 map block>[nMapBlocks]
 std::vector<uint8_t> RoomData::exportSnesData() const
 {
-    return lz4HcCompress(data);
+    if (mapBlocks.empty()) {
+        return lz4HcCompress(data);
+    }
+
+    if (mapBlocks.size() > UINT8_MAX) {
+        throw runtime_error(u8"Too many map blocks");
+    }
+
+    std::vector<uint8_t> out(1 + mapBlocks.size() * 2);
+    out.front() = mapBlocks.size();
+
+    const auto roomData = lz4HcCompress(data);
+    out.insert(out.end(), roomData.begin(), roomData.end());
+
+    for (const auto [i, block] : const_enumerate(mapBlocks)) {
+        const unsigned offset = out.size();
+        if (offset > UINT16_MAX) {
+            throw runtime_error(u8"Room data too large");
+        }
+        out.at(1 + i * 2) = offset & 0xff;
+        out.at(2 + i * 2) = (offset >> 8) & 0xff;
+
+        const auto compressed = lz4HcCompress(block);
+        out.insert(out.end(), compressed.begin(), compressed.end());
+    }
+
+    return out;
+}
+
+RoomSizeReport roomSizeReport(const RoomData& data, const std::vector<uint8_t>& snesData)
+{
+    size_t largestDecompression = data.data.size();
+    for (const auto& block : data.mapBlocks) {
+        largestDecompression = std::max(largestDecompression, block.size());
+    }
+
+    return {
+        .roomDataBytes = data.data.size(),
+        .nMapBlocks = data.mapBlocks.size(),
+        .romBytes = snesData.size(),
+        .largestDecompression = largestDecompression,
+    };
+}
+
+void writeSizeReport(StringStream& out, const RoomInput& input, const RoomSizeReport& report)
+{
+    out.write(input.name, u8",", input.map.width(), u8",", input.map.height(), u8",",
+              report.roomDataBytes, u8",", report.nMapBlocks, u8",",
+              report.romBytes, u8",", report.largestDecompression, u8"\n");
 }
 
 }
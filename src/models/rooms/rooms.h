@@ -13,6 +13,7 @@
 
 namespace UnTech {
 class ErrorList;
+class StringStream;
 
 template <typename T>
 class ExternalFileList;
@@ -52,8 +53,15 @@ struct RoomSettings {
     constexpr static unsigned MIN_ROOM_DATA_SIZE = 1024;
     constexpr static unsigned MAX_ROOM_DATA_SIZE = 40 * 1024;
 
+    constexpr static unsigned MIN_MAP_BLOCK_WIDTH = 4;
+    constexpr static unsigned MAX_MAP_BLOCK_WIDTH = 32;
+
     unsigned roomDataSize = 16 * 1024;
 
+    // Number of map columns in each independently compressed map block.
+    // If 0, the map is stored inside the room data.
+    unsigned mapBlockWidth = 0;
+
     bool operator==(const RoomSettings&) const = default;
 };
 
@@ -138,9 +146,33 @@ struct RoomData {
 
     std::vector<uint8_t> data;
 
+    // Column-major map data, split into blocks of `RoomSettings::mapBlockWidth` columns.
+    // Empty if the map is stored inside `data`.
+    std::vector<std::vector<uint8_t>> mapBlocks;
+
     [[nodiscard]] std::vector<uint8_t> exportSnesData() const;
 };
 
+// RAM and ROM usage of a compiled room
+struct RoomSizeReport {
+    // Size of the decompressed room data (excluding the map blocks)
+    size_t roomDataBytes = 0;
+
+    size_t nMapBlocks = 0;
+
+    // Size of the compressed room data and map blocks
+    size_t romBytes = 0;
+
+    // The largest block of data the engine must decompress at once
+    size_t largestDecompression = 0;
+};
+
+// `snesData` MUST be the output of `data.exportSnesData()`.
+[[nodiscard]] RoomSizeReport roomSizeReport(const RoomData& data, const std::vector<uint8_t>& snesData);
+
+// Writes the RAM and ROM usage of the compiled room to `out` (as a CSV row).
+void writeSizeReport(StringStream& out, const RoomInput& input, const RoomSizeReport& report);
+
 std::shared_ptr<const RoomData>
 compileRoom(const RoomInput& input, const ExternalFileList<RoomInput>& roomsList,
             const Resources::CompiledScenesData& compiledScenes, const Entity::CompiledEntityRomData& entityRomData, const RoomSettings& roomSettings,
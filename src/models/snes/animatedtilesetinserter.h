@@ -9,6 +9,7 @@
 #include "tile.h"
 #include "tilesetinserter.h"
 #include <algorithm>
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
 
@@ -21,12 +22,13 @@ class AnimatedTilesetInserter {
 
 private:
     std::vector<TilesetT>& _tilesets;
-    std::unordered_map<std::vector<TileT>, TilesetInserterOutput> _map;
+    std::pmr::unordered_map<std::pmr::vector<TileT>, TilesetInserterOutput> _map;
 
 public:
-    AnimatedTilesetInserter(std::vector<TilesetT>& tilesets)
+    // The tile map is allocated with `memoryResource`
+    AnimatedTilesetInserter(std::vector<TilesetT>& tilesets, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
         : _tilesets(tilesets)
-        , _map()
+        , _map(memoryResource)
     {
         assert(nFrames() > 0);
 
@@ -36,7 +38,7 @@ public:
             assert(tileset.size() == nTiles);
         }
 
-        std::vector<TileT> tiles(tilesets.size());
+        std::pmr::vector<TileT> tiles(tilesets.size(), memoryResource);
 
         for (const auto t : range(tilesets.front().size())) {
             for (const auto f : range(nFrames())) {
@@ -48,7 +50,7 @@ public:
 
     [[nodiscard]] unsigned nFrames() const { return _tilesets.size(); }
 
-    const TilesetInserterOutput getOrInsert(const std::vector<TileT>& tiles)
+    const TilesetInserterOutput getOrInsert(const std::pmr::vector<TileT>& tiles)
     {
         assert(tiles.size() == nFrames());
 
@@ -63,7 +65,7 @@ public:
     }
 
 private:
-    TilesetInserterOutput insertNewTile(const std::vector<TileT>& tiles)
+    TilesetInserterOutput insertNewTile(const std::pmr::vector<TileT>& tiles)
     {
         assert(tiles.size() == _tilesets.size());
 
@@ -78,19 +80,21 @@ private:
         return { tileId, false, false };
     }
 
-    void addToMap(const std::vector<TileT>& tiles, unsigned tileId)
+    void addToMap(const std::pmr::vector<TileT>& tiles, unsigned tileId)
     {
         assert(tiles.size() == nFrames());
 
-        std::vector<TileT> hFliped(tiles.size());
+        std::pmr::memory_resource* memoryResource = _map.get_allocator().resource();
+
+        std::pmr::vector<TileT> hFliped(tiles.size(), memoryResource);
         std::transform(tiles.begin(), tiles.end(), hFliped.begin(),
                        [](const auto& t) { return t.hFlip(); });
 
-        std::vector<TileT> vFliped(tiles.size());
+        std::pmr::vector<TileT> vFliped(tiles.size(), memoryResource);
         std::transform(tiles.begin(), tiles.end(), vFliped.begin(),
                        [](const auto& t) { return t.vFlip(); });
 
-        std::vector<TileT> hvFliped(tiles.size());
+        std::pmr::vector<TileT> hvFliped(tiles.size(), memoryResource);
         std::transform(tiles.begin(), tiles.end(), hvFliped.begin(),
                        [](const auto& t) { return t.hvFlip(); });
 
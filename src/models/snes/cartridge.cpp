@@ -17,6 +17,7 @@
 namespace UnTech::Snes::Cartridge {
 
 constexpr size_t HEADER_ADDR = 0xffb0;
+constexpr size_t HEADER_END = 0x10000;
 constexpr size_t CHECKSUM_COMPLEMENT_ADDR = 0xffdc;
 constexpr size_t CHECKSUM_ADDR = 0xffde;
 
@@ -99,36 +100,52 @@ static size_t checksumBlock(const std::vector<uint8_t>& data, size_t offset, siz
     return std::accumulate(data.begin() + offset, data.begin() + offset + size, size_t(0));
 }
 
-uint16_t calculateChecksum(const std::vector<uint8_t>& rom, MemoryMap memoryMap)
-{
-    static_assert(sizeof(int) > sizeof(uint16_t) + 1, "int too small");
-    static_assert(INT_MAX > MAX_ROM_SIZE * 256, "int too small");
+// A ROM that is not a power of two in size is split into two parts.
+// The second part is mirrored until it is the same size as the first part.
+struct ChecksumLayout {
+    size_t part1Size;
+    unsigned part2Count;
+};
 
-    if (rom.size() < MIN_ROM_SIZE) {
+static ChecksumLayout checksumLayout(const size_t romSize)
+{
+    if (romSize < MIN_ROM_SIZE) {
         throw runtime_error(u8"ROM is to small (minimum ", MIN_ROM_STRING, u8").");
     }
-    if (rom.size() > MAX_ROM_SIZE) {
+    if (romSize > MAX_ROM_SIZE) {
         throw runtime_error(u8"ROM is to large (maximum ", MAX_ROM_STRING, u8").");
     }
 
-    unsigned part1Size = 1;
-    while (part1Size <= rom.size()) {
+    size_t part1Size = 1;
+    while (part1Size <= romSize) {
         part1Size <<= 1;
     }
     part1Size >>= 1;
 
-    const unsigned part1 = checksumBlock(rom, 0, part1Size);
-
-    unsigned part2 = 0;
     unsigned part2Count = 0;
-    if (part1Size != rom.size()) {
-        unsigned part2Size = rom.size() - part1Size;
+    if (part1Size != romSize) {
+        const size_t part2Size = romSize - part1Size;
 
         part2Count = part1Size / part2Size;
         if (part1Size % part2Size != 0) {
             throw runtime_error(u8"Invalid ROM size.");
         }
+    }
+
+    return { part1Size, part2Count };
+}
 
+uint16_t calculateChecksum(const std::vector<uint8_t>& rom, MemoryMap memoryMap)
+{
+    static_assert(sizeof(int) > sizeof(uint16_t) + 1, "int too small");
+    static_assert(INT_MAX > MAX_ROM_SIZE * 256, "int too small");
+
+    const auto [part1Size, part2Count] = checksumLayout(rom.size());
+
+    const unsigned part1 = checksumBlock(rom, 0, part1Size);
+
+    unsigned part2 = 0;
+    if (part1Size != rom.size()) {
         part2 = checksumBlock(rom, part1Size, rom.size() - part1Size);
     }
 
@@ -169,4 +186,114 @@ void writeChecksum(const std::filesystem::path& filename, uint16_t checksum, Mem
     out.close();
 }
 
+static std::vector<uint8_t> readBlock(std::istream& file, const size_t offset, const size_t size)
+{
+    std::vector<uint8_t> data(size);
+    file.seekg(offset);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    return data;
+}
+
+static RomChecksum readRomChecksum(std::istream& file, const size_t romSize, MemoryMap memoryMap)
+{
+    // isHeaderValid() and readChecksum() only access the first MIN_ROM_SIZE bytes of the ROM
+    const std::vector<uint8_t> firstBlock = readBlock(file, 0, MIN_ROM_SIZE);
+
+    // prevents user from accidentally corrupting a file that was not made by untech-engine.
+    if (isHeaderValid(firstBlock, memoryMap) == false) {
+        throw runtime_error(u8"Could not find header. Header must match `snes_header.inc`");
+    }
+
+    const unsigned ccAddr = checksumCompelementAddress(memoryMap);
+
+    return {
+        .romSize = romSize,
+        .checksum = readChecksum(firstBlock, memoryMap),
+        .complement = uint16_t(firstBlock.at(ccAddr) | firstBlock.at(ccAddr + 1) << 8),
+    };
+}
+
+RomChecksum readRomChecksum(const std::filesystem::path& filename, MemoryMap memoryMap)
+{
+    // Throws if the ROM is an invalid size
+    const size_t romSize = std::filesystem::file_size(filename);
+    checksumLayout(romSize);
+
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file) {
+        throw runtime_error(u8"Error opening file: ", filename.u8string());
+    }
+    file.exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
+
+    return readRomChecksum(file, romSize, memoryMap);
+}
+
+PatchRomResult patchRom(const std::filesystem::path& filename, MemoryMap memoryMap, const RomChecksum& expected,
+                        const std::vector<RomPatch>& patches)
+{
+    const size_t romSize = std::filesystem::file_size(filename);
+    const auto [part1Size, part2Count] = checksumLayout(romSize);
+
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file) {
+        throw runtime_error(u8"Error opening file: ", filename.u8string());
+    }
+    file.exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
+
+    const RomChecksum oldChecksum = readRomChecksum(file, romSize, memoryMap);
+    if (oldChecksum != expected) {
+        throw runtime_error(u8"The ROM has been modified or reassembled, it cannot be patched");
+    }
+
+    const size_t headerStart = headerAddress(memoryMap);
+    const size_t headerEnd = headerStart + (HEADER_END - HEADER_ADDR);
+
+    int64_t checksumDelta = 0;
+    unsigned nChanged = 0;
+
+    for (const RomPatch& patch : patches) {
+        const size_t patchEnd = patch.offset + patch.data.size();
+
+        if (patchEnd > romSize) {
+            throw out_of_range(u8"ROM patch is outside the ROM (offset ", patch.offset, u8", size ", patch.data.size(), u8")");
+        }
+        if (patch.offset < headerEnd && patchEnd > headerStart) {
+            throw runtime_error(u8"Cannot patch the ROM header");
+        }
+
+        const std::vector<uint8_t> oldData = readBlock(file, patch.offset, patch.data.size());
+        if (std::equal(oldData.begin(), oldData.end(), patch.data.begin(), patch.data.end())) {
+            continue;
+        }
+
+        for (const auto i : range(oldData.size())) {
+            const int64_t weight = patch.offset + i < part1Size ? 1 : part2Count;
+            checksumDelta += weight * (int64_t(patch.data[i]) - int64_t(oldData[i]));
+        }
+
+        file.seekp(patch.offset);
+        file.write(reinterpret_cast<const char*>(patch.data.data()), patch.data.size());
+
+        nChanged++;
+    }
+
+    file.close();
+
+    if (nChanged == 0) {
+        return { nChanged, oldChecksum };
+    }
+
+    const uint16_t newChecksum = ((oldChecksum.checksum + checksumDelta) % 0x10000 + 0x10000) % 0x10000;
+    writeChecksum(filename, newChecksum, memoryMap);
+
+    return {
+        .nChanged = nChanged,
+        .checksum = {
+            .romSize = romSize,
+            .checksum = newChecksum,
+            .complement = uint16_t(0xffff ^ newChecksum),
+        },
+    };
+}
+
 }
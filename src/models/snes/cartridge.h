@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -32,4 +33,42 @@ uint16_t calculateChecksum(const std::vector<uint8_t>& rom, MemoryMap memoryMap)
 // throws an exception if writeChecksum is unable to write to file
 void writeChecksum(const std::filesystem::path& filename, uint16_t checksum, MemoryMap memoryMap);
 
+// The size and checksum words of a ROM file.
+// Used to detect a ROM that has been modified or reassembled.
+struct RomChecksum {
+    size_t romSize;
+    uint16_t checksum;
+    uint16_t complement;
+
+    bool operator==(const RomChecksum&) const = default;
+};
+
+// Only reads the first 64 KiB of the file.
+//
+// throws an exception if the header is invalid or the ROM is an invalid size.
+RomChecksum readRomChecksum(const std::filesystem::path& filename, MemoryMap memoryMap);
+
+struct RomPatch {
+    size_t offset;
+    std::span<const uint8_t> data;
+};
+
+struct PatchRomResult {
+    // Number of patches that changed the file
+    unsigned nChanged;
+
+    RomChecksum checksum;
+};
+
+// Writes `patches` to an existing sfc file and updates the checksum from the
+// difference between the old and new data.
+//
+// Only the first 64 KiB of the file and the patched regions are read.
+// The checksum in the file MUST be valid (ie, written by `untech-write-sfc-checksum`).
+//
+// throws an exception if the header is invalid, the file does not match `expected`,
+// a patch is outside the ROM, a patch overlaps the header or the file cannot be written to.
+PatchRomResult patchRom(const std::filesystem::path& filename, MemoryMap memoryMap, const RomChecksum& expected,
+                        const std::vector<RomPatch>& patches);
+
 }
@@ -8,6 +8,7 @@
 
 #include "tile.h"
 #include "models/common/bit.h"
+#include "models/common/grid.h"
 #include "models/common/image.h"
 #include "models/common/iterators.h"
 
@@ -218,4 +219,37 @@ void drawTileset_transparent(Image& image, const unsigned yOffset,
     }
 }
 
+// Draws the palette indexes of the tileset into `image`.
+// Image MUST be large enough to hold tileset.
+template <size_t TS>
+void drawTileset_indexed(grid<uint8_t>& image, const unsigned yOffset,
+                         const std::vector<Tile<TS>>& tileset)
+{
+    if (tileset.empty()) {
+        return;
+    }
+
+    static_assert(TS > 1);
+
+    const size_t width = image.width();
+    const size_t tilesPerLine = width / TS;
+    const size_t nLines = (tileset.size() - 1) / tilesPerLine + 1;
+
+    assert(width % TS == 0);
+    assert(yOffset + nLines * TS <= image.height());
+
+    unsigned y = yOffset;
+    unsigned x = 0;
+
+    for (const Tile<TS>& tile : tileset) {
+        drawTile_noFlip(image, x, y, tile, [](uint8_t& img, uint8_t p) { img = p; });
+
+        x += TS;
+        if (x >= width) {
+            x = 0;
+            y += TS;
+        }
+    }
+}
+
 }
@@ -13,6 +13,10 @@
 #include "models/snes/convert-snescolor.h"
 #include <algorithm>
 #include <array>
+#include <bitset>
+#include <climits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace UnTech::Snes {
@@ -182,7 +186,7 @@ private:
         std::array<uint8_t, TILE_DATA_SIZE> tile{};
         auto tData = tile.begin();
 
-        assert(x + TILE_SIZE < image.size().width && y + TILE_SIZE < image.size().height);
+        assert(x + TILE_SIZE <= image.size().width && y + TILE_SIZE <= image.size().height);
 
         for (const auto py : range(TILE_SIZE)) {
             const auto imgBits = image.scanline(y + py).subspan(x, TILE_SIZE);
@@ -191,7 +195,7 @@ private:
                 *tData++ = c;
             }
         }
-        assert(tData = tile.end());
+        assert(tData == tile.end());
 
         tiles.emplace_back(tile);
     }
@@ -217,86 +221,46 @@ private:
 
     void removeDuplicateColors()
     {
-        // Must use an old-style for loop, palette is resized inside this loop.
-        for (unsigned i = 0; i < palette.size(); i++) {
-            unsigned j = i + 1;
-            while (j < palette.size()) {
-                if (palette[i] == palette[j]) {
-                    palette.erase(palette.begin() + j);
-
-                    for (auto& tile : tiles) {
-                        for (auto& p : tile) {
-                            if (p == j) {
-                                p = i;
-                            }
-                            else if (p > j) {
-                                p = p - 1;
-                            }
-                        }
-                    }
-                }
-                else {
-                    j++;
-                }
-            }
-        }
-    }
-
-    struct TileColors {
-        static_assert(sizeof(unsigned) >= sizeof(uint16_t), "Bad optimisation");
-
-        constexpr static unsigned MAX_PALETTE_COLORS = 15;
+        // Maps each palette index to the first palette index with the same color.
+        std::array<uint8_t, 256> colorMap{};
+        std::unordered_map<uint16_t, uint8_t> firstIndex;
 
-        unsigned nColors = 0;
-        std::array<unsigned, MAX_PALETTE_COLORS> colors = {};
+        std::vector<uint16_t> newPalette;
+        newPalette.reserve(palette.size());
 
-        TileColors() = default;
+        if (palette.size() > colorMap.size()) {
+            throw runtime_error(u8"Too many colors in the image palette");
+        }
 
-        bool containsColor(unsigned pixel)
-        {
-            for (const auto& c : colors) {
-                if (c == pixel) {
-                    return true;
-                }
+        for (const auto [i, c] : const_enumerate(palette)) {
+            const auto [it, inserted] = firstIndex.try_emplace(c, uint8_t(newPalette.size()));
+            if (inserted) {
+                newPalette.push_back(c);
             }
-            return false;
+            colorMap.at(i) = it->second;
         }
 
-        void addColor(unsigned pixel)
-        {
-            if (nColors < MAX_PALETTE_COLORS) {
-                colors.at(nColors) = pixel;
-                nColors++;
-            }
+        if (newPalette.size() == palette.size()) {
+            // No duplicates
+            return;
         }
 
-        [[nodiscard]] unsigned countMatchingColors(const TileColors& cmp) const
-        {
-            unsigned nMatches = 0;
+        palette = std::move(newPalette);
 
-            for (const auto i : range(this->nColors)) {
-                for (const auto j : range(cmp.nColors)) {
-                    if (this->colors.at(i) == cmp.colors.at(j)) {
-                        nMatches++;
-                        break;
-                    }
-                }
+        for (auto& tile : tiles) {
+            for (auto& p : tile) {
+                p = colorMap[p];
             }
-
-            return nMatches;
         }
+    }
 
-        void addMissingColors(const TileColors& toAdd)
-        {
-            for (const auto i : range(toAdd.nColors)) {
-                const unsigned c = toAdd.colors.at(i);
+    // Set of (non-transparent) palette indexes used by a tile or a sub-palette
+    using TileColors = std::bitset<256>;
 
-                if (this->containsColor(c) == false) {
-                    this->addColor(c);
-                }
-            }
-        }
-    };
+    [[nodiscard]] static inline bool isSubset(const TileColors& subset, const TileColors& set)
+    {
+        return (subset & ~set).none();
+    }
 
     void rearrangePalette()
     {
@@ -309,6 +273,7 @@ private:
         std::vector<TileColors> tileColors = rearrangePalette_colorsPerTile();
         std::vector<TileColors> newPalette = rearrangePalette_buildNewPalette(tileColors);
 
+        rearrangePalette_assignTilePalettes(tileColors, newPalette);
         rearrangePalette_rewritePaletteData(newPalette);
         rearrangePalette_rewriteTileData(newPalette);
     }
@@ -319,17 +284,15 @@ private:
         auto it = tileColors.begin();
 
         for (const auto& tile : tiles) {
-            TileColors& tp = *it++;
+            TileColors& tc = *it++;
 
             for (const uint8_t pixel : tile) {
-                if (pixel != 0 && tp.containsColor(pixel) == false) {
-                    if (tp.nColors >= colorsPerPalette) {
-                        throw runtime_error(u8"Tile contains too many colors");
-                    }
-                    else {
-                        tp.addColor(pixel);
-                    }
-                }
+                tc.set(pixel);
+            }
+            tc.reset(0);
+
+            if (tc.count() >= colorsPerPalette) {
+                throw runtime_error(u8"Tile contains too many colors");
             }
         }
         assert(it == tileColors.end());
@@ -337,68 +300,145 @@ private:
         return tileColors;
     }
 
-    inline std::vector<TileColors> rearrangePalette_buildNewPalette(const std::vector<TileColors>& colorsPerTile)
+    // Returns the unique tile color sets that are not a subset of another tile's colors,
+    // sorted by size (largest to smallest).
+    static std::vector<TileColors> rearrangePalette_maximalColorSets(const std::vector<TileColors>& colorsPerTile)
     {
-        // Sort the tile indexes by palette size (largest to smallest).
-        // As nColors is limited, this is faster than std::sort.
-        // ::KUDOS pcx2snes.c by Neviksti::
-
-        std::vector<unsigned> processOrder;
-        processOrder.reserve(tiles.size());
-        for (const auto colorToTest : reverse_range(TileColors::MAX_PALETTE_COLORS)) {
-            for (const auto [i, cpt] : enumerate(colorsPerTile)) {
-                if (colorsPerTile[i].nColors == colorToTest) {
-                    processOrder.push_back(i);
-                }
+        std::vector<TileColors> sets;
+        std::unordered_set<TileColors> seen;
+
+        for (const auto& tc : colorsPerTile) {
+            if (tc.any() && seen.insert(tc).second) {
+                sets.push_back(tc);
             }
         }
-        assert(processOrder.size() == colorsPerTile.size());
 
-        // Build the final palette, processing the tiles with the most colors first.
+        std::stable_sort(sets.begin(), sets.end(),
+                         [](const TileColors& a, const TileColors& b) { return a.count() > b.count(); });
 
-        std::vector<TileColors> newPalette;
-        newPalette.reserve(maxPalettes);
+        std::vector<TileColors> out;
+        out.reserve(sets.size());
 
-        tilePaletteId.assign(tiles.size(), 0);
+        for (const auto& s : sets) {
+            const bool covered = std::any_of(out.begin(), out.end(),
+                                             [&](const TileColors& o) { return isSubset(s, o); });
+            if (!covered) {
+                out.push_back(s);
+            }
+        }
 
-        for (unsigned tileId : processOrder) {
-            const auto& tileColors = colorsPerTile[tileId];
+        return out;
+    }
 
-            if (tileColors.nColors == 0) {
-                continue;
-            }
+    // Best-fit decreasing: each color set (largest first) is added to the
+    // palette that requires the fewest new colors.
+    std::vector<TileColors> rearrangePalette_bestFit(const std::vector<TileColors>& colorSets) const
+    {
+        const unsigned maxColors = colorsPerPalette - 1;
 
-            int bestMatch = -1;
-            unsigned bestIndex = 0;
+        std::vector<TileColors> palettes;
 
-            for (auto [i, toTest] : const_enumerate(newPalette)) {
-                int nMatching = tileColors.countMatchingColors(toTest);
-                int nMissing = tileColors.nColors - nMatching;
+        for (const auto& set : colorSets) {
+            unsigned bestIndex = palettes.size();
+            unsigned bestNewColors = UINT_MAX;
 
-                if (nMatching > bestMatch
-                    && toTest.nColors + nMissing < colorsPerPalette) {
+            for (const auto [i, pal] : const_enumerate(palettes)) {
+                const unsigned unionSize = (pal | set).count();
+                const unsigned newColors = unionSize - pal.count();
 
-                    bestMatch = nMatching;
+                if (unionSize <= maxColors && newColors < bestNewColors) {
                     bestIndex = i;
+                    bestNewColors = newColors;
                 }
             }
 
-            if (bestMatch == (int)tileColors.nColors) {
-                // Palette already exists
-                tilePaletteId[tileId] = bestIndex;
+            if (bestIndex < palettes.size()) {
+                palettes.at(bestIndex) |= set;
+            }
+            else {
+                palettes.push_back(set);
             }
-            else if (bestMatch >= 0) {
-                // Append missing colors to existing palette
-                newPalette[bestIndex].addMissingColors(tileColors);
+        }
+
+        return palettes;
+    }
+
+    // Agglomerative merging: starting with one palette per color set, the two
+    // palettes that share the most colors (and fit in a single palette) are
+    // merged until no more palettes can be merged.
+    //
+    // Slower than best-fit, but it finds packings best-fit misses when the
+    // color sets overlap in complex ways.
+    std::vector<TileColors> rearrangePalette_merge(const std::vector<TileColors>& colorSets) const
+    {
+        const unsigned maxColors = colorsPerPalette - 1;
+
+        std::vector<TileColors> palettes = colorSets;
+
+        while (palettes.size() > 1) {
+            unsigned bestI = 0;
+            unsigned bestJ = 0;
+            int bestShared = -1;
+            unsigned bestUnion = UINT_MAX;
 
-                tilePaletteId[tileId] = bestIndex;
+            for (const auto i : range(palettes.size())) {
+                for (const auto j : range(i + 1, palettes.size())) {
+                    const unsigned unionSize = (palettes[i] | palettes[j]).count();
+                    if (unionSize > maxColors) {
+                        continue;
+                    }
+
+                    const int shared = int(palettes[i].count() + palettes[j].count()) - int(unionSize);
+
+                    if (shared > bestShared || (shared == bestShared && unionSize < bestUnion)) {
+                        bestI = i;
+                        bestJ = j;
+                        bestShared = shared;
+                        bestUnion = unionSize;
+                    }
+                }
             }
-            else {
-                newPalette.push_back(tileColors);
-                tilePaletteId[tileId] = newPalette.size() - 1;
+
+            if (bestShared < 0) {
+                break;
+            }
+
+            const TileColors merged = palettes.at(bestI) | palettes.at(bestJ);
+
+            // Remove the merged palettes and any palettes that are now redundant
+            std::vector<TileColors> remaining;
+            remaining.reserve(palettes.size());
+            remaining.push_back(merged);
+
+            for (const auto [i, p] : const_enumerate(palettes)) {
+                if (i != bestI && i != bestJ && !isSubset(p, merged)) {
+                    remaining.push_back(p);
+                }
+            }
+            palettes = std::move(remaining);
+        }
+
+        return palettes;
+    }
+
+    inline std::vector<TileColors> rearrangePalette_buildNewPalette(const std::vector<TileColors>& colorsPerTile)
+    {
+        const auto colorSets = rearrangePalette_maximalColorSets(colorsPerTile);
+
+        std::vector<TileColors> newPalette = rearrangePalette_bestFit(colorSets);
+
+        if (newPalette.size() > maxPalettes) {
+            auto merged = rearrangePalette_merge(colorSets);
+            if (merged.size() < newPalette.size()) {
+                newPalette = std::move(merged);
             }
         }
 
+        if (newPalette.empty()) {
+            // Every tile is transparent
+            newPalette.emplace_back();
+        }
+
         if (newPalette.size() > maxPalettes) {
             throw runtime_error(u8"Could not rearrange the palette (", newPalette.size(), u8" palettes required, maxPalettes is ", maxPalettes, u8")");
         }
@@ -406,18 +446,33 @@ private:
         return newPalette;
     }
 
+    inline void rearrangePalette_assignTilePalettes(const std::vector<TileColors>& colorsPerTile, const std::vector<TileColors>& newPalette)
+    {
+        tilePaletteId.resize(colorsPerTile.size());
+
+        for (const auto [tileId, tc] : const_enumerate(colorsPerTile)) {
+            auto it = std::find_if(newPalette.begin(), newPalette.end(),
+                                   [&](const TileColors& p) { return isSubset(tc, p); });
+            assert(it != newPalette.end());
+
+            tilePaletteId.at(tileId) = std::distance(newPalette.begin(), it);
+        }
+    }
+
     inline void rearrangePalette_rewritePaletteData(const std::vector<TileColors>& newPalette)
     {
         std::vector<uint16_t> oldPalette = palette;
         palette.assign(newPalette.size() * colorsPerPalette, 0);
 
         for (auto [p, pal] : const_enumerate(newPalette)) {
-            unsigned startingColor = p * colorsPerPalette;
+            unsigned paletteColor = p * colorsPerPalette;
 
-            palette[startingColor] = oldPalette[0];
+            palette.at(paletteColor++) = oldPalette.at(0);
 
-            for (const auto c : range(pal.nColors)) {
-                palette.at(startingColor + c + 1) = oldPalette.at(pal.colors.at(c));
+            for (const auto c : range(oldPalette.size())) {
+                if (pal.test(c)) {
+                    palette.at(paletteColor++) = oldPalette.at(c);
+                }
             }
         }
     }
@@ -431,8 +486,11 @@ private:
         for (const auto& pal : newPalette) {
             auto& map = *pIt++;
 
-            for (const auto c : range(pal.nColors)) {
-                map.at(pal.colors.at(c)) = c + 1;
+            unsigned paletteColor = 1;
+            for (const auto c : range(pal.size())) {
+                if (pal.test(c)) {
+                    map.at(c) = paletteColor++;
+                }
             }
         }
         assert(pIt == paletteMap.end());
@@ -491,6 +549,35 @@ void Image2Snes::process(const IndexedImage& image)
     _palette = converter.buildSnesColorPalette();
 }
 
+void Image2Snes::moveTilesToSharedTileset(TilesetInserter8px& sharedTileset)
+{
+    // Tiles are inserted in tileset order to ensure the transparent tile
+    // (if present) is inserted first.
+    std::vector<TilesetInserterOutput> tileMap;
+    tileMap.reserve(_tileset.size());
+
+    for (const auto& tile : _tileset) {
+        tileMap.push_back(sharedTileset.getOrInsert(tile));
+    }
+
+    for (const auto mapId : range(_tilemap.nMaps())) {
+        for (auto& cell : _tilemap.map(mapId)) {
+            const auto& to = tileMap.at(cell.character() - _tileOffset);
+
+            cell.setCharacter(to.tileId + _tileOffset);
+            cell.setHFlip(cell.hFlip() ^ to.hFlip);
+            cell.setVFlip(cell.vFlip() ^ to.vFlip);
+        }
+    }
+
+    _tileset.clear();
+
+    const auto nTiles = sharedTileset.tileset().size();
+    if (nTiles > _maxTiles) {
+        throw runtime_error(u8"Too many tiles in the shared tileset (", nTiles, u8" tiles required, maxTiles is ", _maxTiles, u8")");
+    }
+}
+
 std::vector<uint8_t> Image2Snes::paletteSnesData() const
 {
     std::vector<uint8_t> out(_palette.size() * 2);
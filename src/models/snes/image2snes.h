@@ -12,6 +12,7 @@
 #include "models/snes/tile-data.h"
 #include "models/snes/tile.h"
 #include "models/snes/tilemap.h"
+#include "models/snes/tilesetinserter.h"
 
 #include <vector>
 
@@ -49,6 +50,15 @@ public:
     [[nodiscard]] std::vector<uint8_t> paletteSnesData() const;
 
     void process(const IndexedImage& image);
+
+    // Moves the tiles of a processed image into a tileset shared by multiple
+    // images, removing any duplicates and updating the tilemap to match.
+    //
+    // Afterwards `tileset()` is empty and the tilemap characters point to the
+    // shared tileset (offset by tileOffset).
+    //
+    // Throws an exception if the shared tileset contains more than maxTiles tiles.
+    void moveTilesToSharedTileset(TilesetInserter8px& sharedTileset);
 };
 
 }
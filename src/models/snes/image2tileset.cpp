@@ -38,11 +38,20 @@ void ImageToTileset::convertAndSave(const IndexedImage& image, BitDepthSpecial b
 
 void ImageToTileset::writeTileset(const std::filesystem::path& filename) const
 {
-    const std::vector<uint8_t> data = snesTileData(_tileset, _bitDepth);
-    File::writeFile(filename, data);
+    File::writeFile(filename, tilesetSnesData());
 }
 
 void ImageToTileset::writePalette(const std::filesystem::path& filename) const
+{
+    File::writeFile(filename, paletteSnesData());
+}
+
+std::vector<uint8_t> ImageToTileset::tilesetSnesData() const
+{
+    return snesTileData(_tileset, _bitDepth);
+}
+
+std::vector<uint8_t> ImageToTileset::paletteSnesData() const
 {
     std::vector<uint8_t> out(_palette.size() * 2);
     auto outIt = out.begin();
@@ -53,7 +62,7 @@ void ImageToTileset::writePalette(const std::filesystem::path& filename) const
     }
     assert(outIt == out.end());
 
-    File::writeFile(filename, out);
+    return out;
 }
 
 void ImageToTileset::process(const IndexedImage& image)
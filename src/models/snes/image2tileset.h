@@ -47,6 +47,9 @@ public:
     void writeTileset(const std::filesystem::path& filename) const;
     void writePalette(const std::filesystem::path& filename) const;
 
+    [[nodiscard]] std::vector<uint8_t> tilesetSnesData() const;
+    [[nodiscard]] std::vector<uint8_t> paletteSnesData() const;
+
     [[nodiscard]] BitDepthSpecial bitDepth() const { return _bitDepth; }
 
     auto& tileset() { return _tileset; }
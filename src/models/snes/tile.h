@@ -91,9 +91,9 @@ struct hash<::UnTech::Snes::Tile<TS>> {
         return seed;
     }
 };
-template <size_t TS>
-struct hash<std::vector<::UnTech::Snes::Tile<TS>>> {
-    size_t operator()(const std::vector<::UnTech::Snes::Tile<TS>>& tiles) const
+template <size_t TS, typename Allocator>
+struct hash<std::vector<::UnTech::Snes::Tile<TS>, Allocator>> {
+    size_t operator()(const std::vector<::UnTech::Snes::Tile<TS>, Allocator>& tiles) const
         __attribute__(IGNORE_UNSIGNED_OVERFLOW_ATTR)
     {
         size_t seed = 0;
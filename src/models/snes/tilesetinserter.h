@@ -8,6 +8,7 @@
 
 #include "tile.h"
 #include "models/common/iterators.h"
+#include <memory_resource>
 #include <unordered_map>
 
 namespace UnTech::Snes {
@@ -29,12 +30,13 @@ public:
 private:
     TilesetT& _tileset;
 
-    std::unordered_map<TileT, TilesetInserterOutput> _map;
+    std::pmr::unordered_map<TileT, TilesetInserterOutput> _map;
 
 public:
-    TilesetInserter(TilesetT& tileset)
+    // The tile map is allocated with `memoryResource`
+    TilesetInserter(TilesetT& tileset, std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource())
         : _tileset(tileset)
-        , _map()
+        , _map(memoryResource)
     {
         for (const auto t : range(tileset.size())) {
             addToMap(t);
@@ -53,6 +55,8 @@ public:
         }
     }
 
+    [[nodiscard]] const TilesetT& tileset() const { return _tileset; }
+
     const TileT getTile(const TilesetInserterOutput& tio) const
     {
         return _tileset.at(tio.tileId).flip(tio.hFlip, tio.vFlip);
@@ -0,0 +1,480 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "synthetic-project.h"
+#include "models/common/exceptions.h"
+#include "models/common/image.h"
+#include "models/common/iterators.h"
+#include "models/common/stringbuilder.h"
+#include "models/common/u8strings.h"
+#include "models/metasprite/frameset-exportorder.h"
+#include "models/metatiles/metatiles-serializer.h"
+#include "models/project/project.h"
+#include "models/rooms/rooms-serializer.h"
+#include "models/snes/convert-snescolor.h"
+#include <unordered_set>
+
+#include "vendor/lodepng/lodepng.h"
+
+namespace UnTech::Bench {
+
+constexpr unsigned PALETTE_WIDTH = 16;
+constexpr unsigned PALETTE_ROWS_PER_FRAME = 4;
+constexpr unsigned PALETTE_FRAMES = 2;
+
+constexpr unsigned N_TILESET_FRAMES = 2;
+constexpr unsigned N_UNIQUE_TILESET_TILES = 160;
+constexpr unsigned N_ANIMATED_TILES = 16;
+
+constexpr unsigned N_EXPORTED_FRAMES = 4;
+
+static const idstring EXPORT_ORDER_NAME = idstring::fromString(u8"synthetic_eo");
+static const idstring ENTITY_LIST_ID = idstring::fromString(u8"enemies");
+static const idstring PLAYER_FUNCTION_TABLE = idstring::fromString(u8"SyntheticPlayer");
+static const idstring ENTITY_FUNCTION_TABLE = idstring::fromString(u8"SyntheticEntity");
+static const idstring SCENE_SETTINGS_NAME = idstring::fromString(u8"synthetic_settings");
+static const idstring PLAYER_NAME = idstring::fromString(u8"player");
+static const idstring ACTION_POINT_NAME = idstring::fromString(u8"Shoot");
+static const idstring ENTRANCE_NAME = idstring::fromString(u8"entrance_0");
+
+static idstring numberedName(const std::u8string_view prefix, const unsigned i)
+{
+    return idstring::fromString(stringBuilder(prefix, i));
+}
+
+static idstring frameName(const unsigned i) { return numberedName(u8"f", i); }
+static idstring paletteName(const unsigned i) { return numberedName(u8"palette_", i); }
+static idstring tilesetName(const unsigned i) { return numberedName(u8"tileset_", i); }
+static idstring sceneName(const unsigned i) { return numberedName(u8"scene_", i); }
+static idstring roomName(const unsigned i) { return numberedName(u8"room_", i); }
+static idstring frameSetName(const unsigned i) { return numberedName(u8"fs_", i); }
+static idstring entityName(const unsigned i) { return numberedName(u8"entity_", i); }
+
+static std::filesystem::path fileFor(const std::filesystem::path& directory, const idstring& name, const std::u8string_view extension)
+{
+    return directory / std::filesystem::path(stringBuilder(name.str(), u8".", extension));
+}
+
+static void writePngImage(const Image& image, const std::filesystem::path& filename)
+{
+    static_assert(sizeof(rgba) == 4);
+
+    const auto error = lodepng_encode32_file(filename.string().c_str(),
+                                             reinterpret_cast<const unsigned char*>(image.data().data()),
+                                             image.size().width, image.size().height);
+    if (error) {
+        throw runtime_error(u8"Unable to write ", filename.u8string(), u8": ", convert_old_string(lodepng_error_text(error)));
+    }
+}
+
+std::vector<Snes::Tile8px> randomTiles(Random& rng, const unsigned count, const unsigned nColors)
+{
+    std::vector<Snes::Tile8px> tiles(count);
+
+    for (auto& tile : tiles) {
+        // Runs of pixels compress better and look more like real graphics than noise
+        uint8_t c = rng.range(nColors);
+        for (auto& p : tile.data()) {
+            if (rng.range(4) == 0) {
+                c = rng.range(nColors);
+            }
+            p = c;
+        }
+    }
+
+    return tiles;
+}
+
+std::vector<Snes::SnesColor> randomColors(Random& rng, const unsigned count)
+{
+    std::vector<Snes::SnesColor> colors;
+    colors.reserve(count);
+
+    std::unordered_set<uint16_t> used;
+
+    while (colors.size() < count) {
+        const uint16_t c = rng.range(0x8000);
+        if (used.insert(c).second) {
+            colors.emplace_back(c);
+        }
+    }
+
+    return colors;
+}
+
+static void drawTile(Image& image, const unsigned x, const unsigned y,
+                     const Snes::Tile8px& tile, const bool hFlip, const bool vFlip,
+                     const std::vector<rgba>& colors, const unsigned firstColor)
+{
+    const Snes::Tile8px t = tile.flip(hFlip, vFlip);
+
+    for (const auto ty : range(t.TILE_SIZE)) {
+        for (const auto tx : range(t.TILE_SIZE)) {
+            image.setPixel(x + tx, y + ty, colors.at(firstColor + t.pixel(tx, ty)));
+        }
+    }
+}
+
+// Each palette is `PALETTE_FRAMES` frames of `PALETTE_ROWS_PER_FRAME` 16 color palettes.
+// Every color in a palette is unique to ensure the tileset tiles are converted with the correct palette.
+static std::vector<rgba> generatePalette(Random& rng, Project::ProjectFile& project,
+                                         const unsigned index, const std::filesystem::path& imageDir)
+{
+    constexpr unsigned nColors = PALETTE_WIDTH * PALETTE_ROWS_PER_FRAME * PALETTE_FRAMES;
+
+    std::vector<rgba> colors;
+    colors.reserve(nColors);
+    for (const auto& c : randomColors(rng, nColors)) {
+        colors.push_back(Snes::toRgb(c));
+    }
+
+    Image image(PALETTE_WIDTH, PALETTE_ROWS_PER_FRAME * PALETTE_FRAMES);
+    std::copy(colors.begin(), colors.end(), image.data().begin());
+
+    Resources::PaletteInput palette;
+    palette.name = paletteName(index);
+    palette.paletteImageFilename = fileFor(imageDir, palette.name, u8"png");
+    palette.rowsPerFrame = PALETTE_ROWS_PER_FRAME;
+    palette.animationDelay = 10 + rng.range(20);
+    palette.skipFirstFrame = false;
+
+    writePngImage(image, palette.paletteImageFilename);
+
+    project.palettes.insert_back(std::move(palette));
+
+    // Only the first frame is used to convert the tileset images
+    colors.resize(PALETTE_WIDTH * PALETTE_ROWS_PER_FRAME);
+    return colors;
+}
+
+static void generateTileset(Random& rng, Project::ProjectFile& project, const unsigned index,
+                            const std::vector<rgba>& paletteColors,
+                            const std::filesystem::path& directory, const std::filesystem::path& imageDir)
+{
+    using namespace MetaTiles;
+
+    constexpr unsigned TS = Snes::Tile8px::TILE_SIZE;
+    constexpr unsigned IMAGE_SIZE = TILESET_WIDTH * METATILE_SIZE_PX;
+    constexpr unsigned TILES_PER_ROW = IMAGE_SIZE / TS;
+    constexpr unsigned N_TILES = TILES_PER_ROW * TILES_PER_ROW;
+
+    static_assert(TILESET_WIDTH == TILESET_HEIGHT);
+
+    struct TileRef {
+        unsigned tile;
+        unsigned palette;
+        bool hFlip;
+        bool vFlip;
+    };
+
+    const auto pool = randomTiles(rng, N_UNIQUE_TILESET_TILES, PALETTE_WIDTH);
+    const auto animatedPool = randomTiles(rng, N_ANIMATED_TILES * N_TILESET_FRAMES, PALETTE_WIDTH);
+
+    std::vector<TileRef> tileMap(N_TILES);
+    for (auto& t : tileMap) {
+        t.tile = rng.range(pool.size());
+        t.palette = rng.range(PALETTE_ROWS_PER_FRAME);
+        t.hFlip = rng.boolean();
+        t.vFlip = rng.boolean();
+    }
+
+    std::vector<unsigned> animatedPositions(N_ANIMATED_TILES);
+    for (auto& p : animatedPositions) {
+        p = rng.range(N_TILES);
+    }
+
+    auto mt = std::make_unique<MetaTileTilesetInput>();
+    mt->name = tilesetName(index);
+    mt->palettes.push_back(paletteName(index));
+    mt->animationFrames.conversionPalette = paletteName(index);
+    mt->animationFrames.animationDelay = 15 + rng.range(30);
+
+    for (const auto frameId : range(N_TILESET_FRAMES)) {
+        Image image(IMAGE_SIZE, IMAGE_SIZE);
+
+        for (const auto [i, t] : const_enumerate(tileMap)) {
+            drawTile(image, (i % TILES_PER_ROW) * TS, (i / TILES_PER_ROW) * TS,
+                     pool.at(t.tile), t.hFlip, t.vFlip, paletteColors, t.palette * PALETTE_WIDTH);
+        }
+
+        for (const auto [i, pos] : const_enumerate(animatedPositions)) {
+            const auto& t = tileMap.at(pos);
+            drawTile(image, (pos % TILES_PER_ROW) * TS, (pos / TILES_PER_ROW) * TS,
+                     animatedPool.at(i * N_TILESET_FRAMES + frameId), false, false, paletteColors, t.palette * PALETTE_WIDTH);
+        }
+
+        const auto filename = imageDir / std::filesystem::path(stringBuilder(mt->name.str(), u8"_", frameId, u8".png"));
+        writePngImage(image, filename);
+
+        mt->animationFrames.frameImageFilenames.push_back(filename);
+    }
+
+    for (auto& tc : mt->tileCollisions) {
+        tc = rng.range(4) == 0 ? TileCollisionType::SOLID : TileCollisionType::EMPTY;
+    }
+    for (auto& p : mt->tilePriorities.data) {
+        p = rng.range(256);
+    }
+
+    auto filename = fileFor(directory, mt->name, mt->FILE_EXTENSION);
+    project.metaTileTilesets.insert_back(filename, std::move(mt));
+}
+
+static void generateScenes(Project::ProjectFile& project, const unsigned nTilesets)
+{
+    using namespace Resources;
+
+    SceneSettingsInput settings;
+    settings.name = SCENE_SETTINGS_NAME;
+    settings.bgMode = BgMode::MODE_1;
+    settings.layerTypes = { LayerType::MetaTileTileset, LayerType::None, LayerType::None, LayerType::None };
+    project.resourceScenes.settings.insert_back(std::move(settings));
+
+    for (const auto i : range(nTilesets)) {
+        SceneInput scene;
+        scene.name = sceneName(i);
+        scene.sceneSettings = SCENE_SETTINGS_NAME;
+        scene.palette = paletteName(i);
+        scene.layers.at(0) = tilesetName(i);
+
+        project.resourceScenes.scenes.insert_back(std::move(scene));
+    }
+}
+
+static void generateExportOrder(Project::ProjectFile& project, const std::filesystem::path& directory)
+{
+    auto eo = std::make_unique<MetaSprite::FrameSetExportOrder>();
+    eo->name = EXPORT_ORDER_NAME;
+
+    for (const auto i : range(N_EXPORTED_FRAMES)) {
+        eo->stillFrames.insert_back({ frameName(i), {} });
+    }
+
+    auto filename = fileFor(directory, eo->name, eo->FILE_EXTENSION);
+    project.frameSetExportOrders.insert_back(filename, std::move(eo));
+}
+
+static void generateFrameSet(Random& rng, Project::ProjectFile& project, const unsigned index,
+                             const std::filesystem::path& directory)
+{
+    using namespace UnTech::MetaSprite;
+    using namespace UnTech::MetaSprite::MetaSprite;
+
+    auto fs = std::make_unique<FrameSet>();
+    fs->name = frameSetName(index);
+    fs->exportOrder = EXPORT_ORDER_NAME;
+    fs->tilesetType = TilesetType::TWO_ROWS;
+
+    fs->smallTileset = randomTiles(rng, 16 + rng.range(48), 16);
+
+    fs->largeTileset.resize(8 + rng.range(40));
+    for (auto& tile : fs->largeTileset) {
+        const auto small = randomTiles(rng, 4, 16);
+        tile = Snes::combineSmallTiles({ small.at(0), small.at(1), small.at(2), small.at(3) });
+    }
+
+    fs->palettes.resize(1 + rng.range(3));
+    for (auto& palette : fs->palettes) {
+        const auto colors = randomColors(rng, palette.size());
+        std::copy(colors.begin(), colors.end(), palette.begin());
+    }
+
+    const unsigned nFrames = N_EXPORTED_FRAMES + rng.range(12);
+    for (const auto fi : range(nFrames)) {
+        Frame frame;
+        frame.name = frameName(fi);
+
+        // 8 objects will fit inside a TWO_ROWS tileset
+        const unsigned nObjects = 1 + rng.range(8);
+        for ([[maybe_unused]] const auto oi : range(nObjects)) {
+            FrameObject obj;
+            obj.size = rng.boolean() ? ObjectSize::LARGE : ObjectSize::SMALL;
+            obj.tileId = obj.size == ObjectSize::LARGE ? rng.range(fs->largeTileset.size())
+                                                       : rng.range(fs->smallTileset.size());
+            obj.location = ms8point(rng.range(-32, 16), rng.range(-32, 16));
+            obj.hFlip = rng.boolean();
+            obj.vFlip = rng.boolean();
+
+            frame.objects.push_back(obj);
+        }
+
+        frame.tileHitbox.exists = true;
+        frame.tileHitbox.aabb = ms8rect(-6, -12, 12, 16);
+
+        frame.hitbox.exists = rng.boolean();
+        frame.hitbox.aabb = ms8rect(-8, -16, 16, 20);
+
+        frame.hurtbox.exists = rng.boolean();
+        frame.hurtbox.aabb = ms8rect(-7, -14, 14, 18);
+
+        fs->frames.insert_back(std::move(frame));
+    }
+
+    auto& fsFile = project.frameSets.emplace_back();
+    fsFile.filename = fileFor(directory, fs->name, fs->FILE_EXTENSION);
+    fsFile.type = FrameSetFile::FrameSetType::METASPRITE;
+    fsFile.msFrameSet = std::move(fs);
+}
+
+static void generateEntities(Project::ProjectFile& project)
+{
+    using namespace Entity;
+
+    EntityRomData& entityRomData = project.entityRomData;
+
+    entityRomData.listIds.push_back(ENTITY_LIST_ID);
+
+    auto addFunctionTable = [&](const idstring& name, const EntityType type) {
+        EntityFunctionTable ft;
+        ft.name = name;
+        ft.entityType = type;
+        ft.exportOrder = EXPORT_ORDER_NAME;
+        entityRomData.functionTables.insert_back(std::move(ft));
+    };
+    addFunctionTable(PLAYER_FUNCTION_TABLE, EntityType::PLAYER);
+    addFunctionTable(ENTITY_FUNCTION_TABLE, EntityType::ENTITY);
+
+    {
+        EntityRomEntry player;
+        player.name = PLAYER_NAME;
+        player.functionTable = PLAYER_FUNCTION_TABLE;
+        player.frameSetId = frameSetName(0);
+        player.displayFrame = frameName(0);
+        entityRomData.players.insert_back(std::move(player));
+    }
+
+    for (const auto [i, fs] : const_enumerate(project.frameSets)) {
+        if (i >= MAX_N_ENTITY_ENTRIES) {
+            break;
+        }
+
+        EntityRomEntry entity;
+        entity.name = entityName(i);
+        entity.functionTable = ENTITY_FUNCTION_TABLE;
+        entity.initialListId = ENTITY_LIST_ID;
+        entity.frameSetId = fs.name();
+        entity.displayFrame = frameName(i % N_EXPORTED_FRAMES);
+        entityRomData.entities.insert_back(std::move(entity));
+    }
+}
+
+static void generateRoom(Random& rng, Project::ProjectFile& project, const unsigned index, const unsigned nTilesets,
+                         const std::filesystem::path& directory)
+{
+    using namespace Rooms;
+
+    auto room = std::make_unique<RoomInput>();
+    room->name = roomName(index);
+    room->scene = sceneName(rng.range(nTilesets));
+
+    const unsigned width = RoomInput::MIN_MAP_WIDTH + rng.range(64);
+    const unsigned height = RoomInput::MIN_MAP_HEIGHT + rng.range(32);
+    room->map = grid<uint8_t>(width, height);
+
+    // Rows of ground with a small number of random tiles, like a platformer level
+    for (const auto y : range(height)) {
+        const uint8_t rowTile = rng.range(4) == 0 ? rng.range(MetaTiles::N_METATILES) : 0;
+        for (const auto x : range(width)) {
+            room->map.set(x, y, rng.range(6) == 0 ? rng.range(MetaTiles::N_METATILES) : rowTile);
+        }
+    }
+
+    const unsigned nEntrances = 1 + rng.range(4);
+    for (const auto i : range(nEntrances)) {
+        room->entrances.insert_back({
+            .name = numberedName(u8"entrance_", i),
+            .position = upoint(rng.range(width * MAP_TILE_SIZE), rng.range(height * MAP_TILE_SIZE)),
+            .orientation = RoomEntranceOrientation(rng.range(4)),
+        });
+    }
+
+    const auto& entities = project.entityRomData.entities;
+    if (!entities.empty()) {
+        const unsigned nGroups = rng.range(4);
+        for (const auto g : range(nGroups)) {
+            EntityGroup group;
+            group.name = numberedName(u8"group_", g);
+
+            const unsigned nEntities = 1 + rng.range(8);
+            for ([[maybe_unused]] const auto e : range(nEntities)) {
+                group.entities.push_back({
+                    .name = {},
+                    .entityId = entities.at(rng.range(entities.size())).name,
+                    .position = point(rng.range(width * MAP_TILE_SIZE), rng.range(height * MAP_TILE_SIZE)),
+                    .parameter = {},
+                });
+            }
+
+            room->entityGroups.insert_back(std::move(group));
+        }
+    }
+
+    auto filename = fileFor(directory, room->name, room->FILE_EXTENSION);
+    project.rooms.insert_back(filename, std::move(room));
+}
+
+std::unique_ptr<Project::ProjectFile> generateSyntheticProject(const SyntheticProjectSettings& settings,
+                                                               const std::filesystem::path& directory)
+{
+    if (settings.nRooms == 0 || settings.nFrameSets == 0 || settings.nTilesets == 0) {
+        throw invalid_argument(u8"A synthetic project requires at least one room, frameSet and tileset");
+    }
+
+    const std::filesystem::path imageDir = directory / "images";
+    std::filesystem::create_directories(imageDir);
+
+    Random rng(settings.seed);
+
+    auto project = std::make_unique<Project::ProjectFile>();
+
+    for (const auto i : range(settings.nTilesets)) {
+        const auto colors = generatePalette(rng, *project, i, imageDir);
+        generateTileset(rng, *project, i, colors, directory, imageDir);
+    }
+    generateScenes(*project, settings.nTilesets);
+
+    project->actionPointFunctions.insert_back({ .name = ACTION_POINT_NAME, .manuallyInvoked = false });
+
+    generateExportOrder(*project, directory);
+    for (const auto i : range(settings.nFrameSets)) {
+        generateFrameSet(rng, *project, i, directory);
+    }
+    generateEntities(*project);
+
+    for (const auto i : range(settings.nRooms)) {
+        generateRoom(rng, *project, i, settings.nTilesets, directory);
+    }
+
+    project->gameState.startingRoom = roomName(0);
+    project->gameState.startingEntrance = ENTRANCE_NAME;
+    project->gameState.startingPlayer = PLAYER_NAME;
+
+    return project;
+}
+
+void saveSyntheticProject(const Project::ProjectFile& project, const std::filesystem::path& filename)
+{
+    for (const auto& item : project.metaTileTilesets) {
+        assert(item.value);
+        MetaTiles::saveMetaTileTilesetInput(*item.value, item.filename);
+    }
+    for (const auto& item : project.frameSetExportOrders) {
+        assert(item.value);
+        MetaSprite::saveFrameSetExportOrder(*item.value, item.filename);
+    }
+    for (const auto& fs : project.frameSets) {
+        assert(fs.msFrameSet);
+        MetaSprite::MetaSprite::saveFrameSet(*fs.msFrameSet, fs.filename);
+    }
+    for (const auto& item : project.rooms) {
+        assert(item.value);
+        Rooms::saveRoomInput(*item.value, item.filename);
+    }
+
+    Project::saveProjectFile(project, filename);
+}
+
+}
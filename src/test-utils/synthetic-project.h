@@ -0,0 +1,77 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include "models/snes/snescolor.h"
+#include "models/snes/tile.h"
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace UnTech::Project {
+struct ProjectFile;
+}
+
+namespace UnTech::Bench {
+
+// A deterministic random number generator.
+//
+// `std::mt19937` produces the same sequence on every standard library, the
+// `std::*_distribution` classes do not (which is why they are not used here).
+class Random {
+    std::mt19937 _rng;
+
+public:
+    explicit Random(unsigned seed)
+        : _rng(seed)
+    {
+    }
+
+    // Returns a value between 0 and `n - 1` (inclusive)
+    unsigned range(unsigned n) { return n > 0 ? _rng() % n : 0; }
+
+    // Returns a value between `min` and `max` (inclusive)
+    int range(int min, int max) { return min + int(range(unsigned(max - min + 1))); }
+
+    bool boolean() { return _rng() & 1; }
+};
+
+struct SyntheticProjectSettings {
+    unsigned seed = 1;
+
+    unsigned nRooms = 16;
+    unsigned nFrameSets = 16;
+
+    // One palette and one scene is created for each tileset
+    unsigned nTilesets = 4;
+};
+
+// Returns `count` random tiles that only use the first `nColors` colors.
+std::vector<Snes::Tile8px> randomTiles(Random& rng, unsigned count, unsigned nColors);
+
+// Returns `count` distinct random colors
+std::vector<Snes::SnesColor> randomColors(Random& rng, unsigned count);
+
+// Generates a valid project (and the png images it uses) inside `directory`.
+//
+// The generated project is the same for a given `settings`.
+//
+// The external files (rooms, tilesets, frameSets and export orders) are
+// stored inside the ProjectFile, they are only written to disk by
+// `saveSyntheticProject()`.
+//
+// Throws an exception on error
+std::unique_ptr<Project::ProjectFile> generateSyntheticProject(const SyntheticProjectSettings& settings,
+                                                               const std::filesystem::path& directory);
+
+// Saves the project file and all of the project's external files.
+//
+// Throws an exception on error
+void saveSyntheticProject(const Project::ProjectFile& project, const std::filesystem::path& filename);
+
+}
@@ -0,0 +1,549 @@
+/*
+ * This file is part of the UnTech Editor Suite.
+ * Copyright (c) 2023, Marcus Rowe <undisbeliever@gmail.com>.
+ * Distributed under The MIT License: https://opensource.org/licenses/MIT
+ */
+
+#include "synthetic-project.h"
+#include "cli/argparser.h"
+#include "models/common/base64.h"
+#include "models/common/errorlist.h"
+#include "models/common/file.h"
+#include "models/common/image.h"
+#include "models/common/indexedimage.h"
+#include "models/common/iterators.h"
+#include "models/common/stringstream.h"
+#include "models/common/u8strings.h"
+#include "models/common/xml/xmlreader.h"
+#include "models/common/xml/xmlwriter.h"
+#include "models/lz4/lz4.h"
+#include "models/metasprite/compiler/combinesmalltiles.h"
+#include "models/metasprite/compiler/romdata.h"
+#include "models/metasprite/compiler/tilesetlayout.h"
+#include "models/metasprite/metasprite-serializer.h"
+#include "models/project/project-compiler.h"
+#include "models/project/project.h"
+#include "models/resources/tile-extractor.hpp"
+#include "models/rooms/rooms-serializer.h"
+#include "models/snes/image2snes.h"
+#include "models/snes/tile-data.h"
+#include "models/snes/tilesetinserter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace UnTech;
+using namespace UnTech::Bench;
+using namespace UnTech::ArgParser;
+
+using Clock = std::chrono::steady_clock;
+
+// Incremented whenever the JSON output changes
+constexpr unsigned JSON_FORMAT_VERSION = 1;
+
+constexpr unsigned MIN_ITERATIONS = 3;
+constexpr unsigned MAX_ITERATIONS = 100000;
+
+struct Args {
+    // The directory to generate the synthetic project in
+    std::filesystem::path inputFilename;
+
+    std::filesystem::path jsonFilename;
+
+    unsigned seed;
+    unsigned nRooms;
+    unsigned nFrameSets;
+    unsigned nTilesets;
+
+    unsigned minTimeMs;
+
+    bool saveProject;
+};
+
+// clang-format off
+constexpr static auto ARG_PARSER_CONFIG = argParserConfig(
+    "UnTech Benchmark",
+    "output directory",
+
+    OptionalArg< &Args::jsonFilename    >{  '\0',   "json",         "write the results to a JSON file" },
+    OptionalArg< &Args::seed            >{  '\0',   "seed",         "synthetic project random seed",            1 },
+    OptionalArg< &Args::nRooms          >{  '\0',   "rooms",        "number of rooms in the synthetic project",  16 },
+    OptionalArg< &Args::nFrameSets      >{  '\0',   "framesets",    "number of frameSets in the synthetic project", 16 },
+    OptionalArg< &Args::nTilesets       >{  '\0',   "tilesets",     "number of tilesets in the synthetic project", 4 },
+    OptionalArg< &Args::minTimeMs       >{  '\0',   "min-time",     "minimum time spent in each benchmark (ms)", 250 },
+    BooleanArg<  &Args::saveProject     >{  '\0',   "save-project", "save the synthetic project to the output directory" }
+);
+// clang-format on
+
+struct BenchmarkResult {
+    std::u8string_view name;
+    unsigned iterations;
+
+    Clock::duration min;
+    Clock::duration median;
+    Clock::duration mean;
+
+    // Size of the benchmark's output.
+    // Used to prevent the benchmark from being optimised out and to detect output changes.
+    size_t outputSize;
+};
+
+// `function` MUST return a `size_t` that depends on the output of the benchmark
+template <typename Function>
+static BenchmarkResult runBenchmark(const std::u8string_view name, const Args& args, Function function)
+{
+    const auto minTime = std::chrono::milliseconds(args.minTimeMs);
+
+    // Warm-up (also fills the ImageCache)
+    size_t outputSize = function();
+
+    std::vector<Clock::duration> times;
+    Clock::duration total{};
+
+    while (times.size() < MIN_ITERATIONS || (total < minTime && times.size() < MAX_ITERATIONS)) {
+        const auto start = Clock::now();
+
+        const size_t s = function();
+
+        const auto t = Clock::now() - start;
+
+        if (s != outputSize) {
+            throw runtime_error(name, u8": output is not deterministic");
+        }
+
+        times.push_back(t);
+        total += t;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    const BenchmarkResult r{
+        .name = name,
+        .iterations = unsigned(times.size()),
+        .min = times.front(),
+        .median = times.at(times.size() / 2),
+        .mean = total / times.size(),
+        .outputSize = outputSize,
+    };
+
+    const auto us = [](const Clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(d).count();
+    };
+
+    stdout_write(name);
+    std::cout << std::string(std::max<size_t>(30, name.size() + 1) - name.size(), ' ')
+              << std::setw(8) << r.iterations << " iterations"
+              << std::fixed << std::setprecision(1)
+              << std::setw(12) << us(r.min) << " us min"
+              << std::setw(12) << us(r.median) << " us median"
+              << std::setw(12) << us(r.mean) << " us mean\n";
+
+    return r;
+}
+
+static std::unique_ptr<Image> tilesToImage(const std::vector<Snes::Tile8px>& tiles, const std::vector<Snes::SnesColor>& palette,
+                                           const unsigned colorsPerPalette, const unsigned nPalettes, const unsigned tilesPerRow)
+{
+    constexpr unsigned TS = Snes::Tile8px::TILE_SIZE;
+
+    auto image = std::make_unique<Image>(tilesPerRow * TS, (tiles.size() + tilesPerRow - 1) / tilesPerRow * TS);
+
+    for (const auto [i, tile] : const_enumerate(tiles)) {
+        const unsigned x = (i % tilesPerRow) * TS;
+        const unsigned y = (i / tilesPerRow) * TS;
+        const unsigned firstColor = (i % nPalettes) * colorsPerPalette;
+
+        for (const auto ty : range(TS)) {
+            for (const auto tx : range(TS)) {
+                image->setPixel(x + tx, y + ty, Snes::toRgb(palette.at(firstColor + tile.pixel(tx, ty))));
+            }
+        }
+    }
+
+    return image;
+}
+
+// A frameSet with a large dynamic tileset, whose frames use small tiles from
+// overlapping groups of tiles (simulating body parts shared between animations).
+static std::unique_ptr<MetaSprite::MetaSprite::FrameSet> smallTilesFrameSet(Random& rng)
+{
+    using namespace UnTech::MetaSprite;
+    using namespace UnTech::MetaSprite::MetaSprite;
+
+    constexpr unsigned N_GROUPS = 48;
+    constexpr unsigned TILES_PER_GROUP = 8;
+    constexpr unsigned N_FRAMES = 192;
+
+    auto fs = std::make_unique<FrameSet>();
+    fs->tilesetType = TilesetType::TWO_ROWS;
+    fs->smallTileset = randomTiles(rng, N_GROUPS * TILES_PER_GROUP, 16);
+
+    for ([[maybe_unused]] const auto fi : range(N_FRAMES)) {
+        Frame frame;
+
+        const unsigned nGroups = 2 + rng.range(3);
+        for ([[maybe_unused]] const auto gi : range(nGroups)) {
+            const unsigned group = rng.range(N_GROUPS);
+            const unsigned nTiles = 3 + rng.range(TILES_PER_GROUP - 3);
+
+            for ([[maybe_unused]] const auto ti : range(nTiles)) {
+                FrameObject obj;
+                obj.size = ObjectSize::SMALL;
+                obj.tileId = group * TILES_PER_GROUP + rng.range(TILES_PER_GROUP);
+                frame.objects.push_back(obj);
+            }
+        }
+
+        fs->frames.insert_back(std::move(frame));
+    }
+
+    return fs;
+}
+
+// Returns the total number of Tile16 tiles (containing small tiles) used by each frame.
+// (ie, the number of small-tile Tile16s transferred to VRAM when every frame is displayed once)
+static size_t countSmallTile16Loads(const MetaSprite::MetaSprite::FrameSet& frameSet,
+                                    const std::pmr::vector<MetaSprite::Compiler::ExportIndex>& frameEntries,
+                                    const MetaSprite::Compiler::SmallTileMap_t& smallTileMap)
+{
+    size_t count = 0;
+
+    std::vector<std::array<uint16_t, 4>> tile16s;
+
+    for (const auto& fe : frameEntries) {
+        tile16s.clear();
+
+        for (const auto& obj : frameSet.frames.at(fe.fsIndex).objects) {
+            if (obj.size == MetaSprite::ObjectSize::SMALL) {
+                const auto& t = smallTileMap.at(obj.tileId);
+                if (std::find(tile16s.begin(), tile16s.end(), t) == tile16s.end()) {
+                    tile16s.push_back(t);
+                }
+            }
+        }
+
+        count += tile16s.size();
+    }
+
+    return count;
+}
+
+template <typename T, typename WriterFunction>
+static std::u8string toXml(const T& input, WriterFunction writerFunction)
+{
+    Xml::XmlWriter xml(u8"untech", 64 * 1024);
+    writerFunction(xml, input);
+    return std::u8string(xml.string_view());
+}
+
+static std::vector<BenchmarkResult> runBenchmarks(const Args& args, const Project::ProjectFile& project)
+{
+    std::vector<BenchmarkResult> results;
+
+    Random rng(args.seed);
+
+    const auto tiles = randomTiles(rng, 4096, 16);
+
+    results.push_back(runBenchmark(u8"snesTileData4bpp", args, [&]() {
+        return Snes::snesTileData4bpp(tiles).size();
+    }));
+
+    {
+        // A small pool of tiles (and their flips), to simulate a tileset with a lot of duplicates
+        const auto pool = randomTiles(rng, 512, 16);
+
+        std::vector<Snes::Tile8px> input(4096);
+        for (auto& t : input) {
+            t = pool.at(rng.range(pool.size())).flip(rng.boolean(), rng.boolean());
+        }
+
+        results.push_back(runBenchmark(u8"TilesetInserter8px", args, [&]() {
+            std::vector<Snes::Tile8px> tileset;
+            Snes::TilesetInserter8px inserter(tileset);
+
+            size_t sum = 0;
+            for (const auto& t : input) {
+                sum += inserter.getOrInsert(t).tileId;
+            }
+            return sum + tileset.size();
+        }));
+    }
+
+    {
+        constexpr unsigned COLORS_PER_PALETTE = 16;
+        constexpr unsigned N_PALETTES = 8;
+
+        const auto palette = randomColors(rng, COLORS_PER_PALETTE * N_PALETTES);
+        const auto image = tilesToImage(std::vector(tiles.begin(), tiles.begin() + 1024), palette,
+                                        COLORS_PER_PALETTE, N_PALETTES, 32);
+
+        results.push_back(runBenchmark(u8"extractTileAndPalette", args, [&]() {
+            Resources::TileAndPalette tp;
+
+            size_t sum = 0;
+            for (unsigned y = 0; y < image->size().height; y += 8) {
+                for (unsigned x = 0; x < image->size().width; x += 8) {
+                    if (Resources::extractTileAndPalette(tp, *image, x, y, palette, COLORS_PER_PALETTE, 0, N_PALETTES)) {
+                        sum += tp.palette + 1;
+                    }
+                }
+            }
+            return sum;
+        }));
+    }
+
+    {
+        // A 4bpp title screen that uses 8 palettes and contains a lot of duplicate colors
+        constexpr unsigned N_PALETTES = 8;
+        constexpr unsigned COLORS_PER_PALETTE = 15;
+        constexpr unsigned N_UNIQUE_COLORS = 1 + N_PALETTES * COLORS_PER_PALETTE;
+
+        const auto colors = randomColors(rng, 256);
+
+        IndexedImage image(256, 224);
+        image.palette().resize(256);
+
+        std::vector<std::vector<uint8_t>> duplicates(N_UNIQUE_COLORS);
+        for (const auto i : range(256)) {
+            const unsigned c = i < N_UNIQUE_COLORS ? i : 1 + rng.range(N_UNIQUE_COLORS - 1);
+            image.palette().at(i) = Snes::toRgb(colors.at(c));
+            duplicates.at(c).push_back(i);
+        }
+
+        for (unsigned y = 0; y < image.size().height; y += 8) {
+            for (unsigned x = 0; x < image.size().width; x += 8) {
+                const unsigned firstColor = 1 + rng.range(N_PALETTES) * COLORS_PER_PALETTE;
+                const unsigned nColors = 4 + rng.range(COLORS_PER_PALETTE - 4);
+
+                for (const auto ty : range(8)) {
+                    for (const auto tx : range(8)) {
+                        const unsigned c = rng.range(4) == 0 ? 0 : firstColor + rng.range(nColors);
+                        const auto& d = duplicates.at(c);
+                        image.setPixel(x + tx, y + ty, d.at(rng.range(d.size())));
+                    }
+                }
+            }
+        }
+
+        results.push_back(runBenchmark(u8"Image2Snes", args, [&]() {
+            Snes::Image2Snes image2Snes(Snes::BitDepthSpecial::BD_4BPP);
+            image2Snes.process(image);
+            return image2Snes.tileset().size() + image2Snes.palette().size();
+        }));
+    }
+
+    {
+        const auto frameSet = smallTilesFrameSet(rng);
+
+        std::pmr::vector<MetaSprite::Compiler::ExportIndex> frameEntries;
+        for (const auto i : range(frameSet->frames.size())) {
+            frameEntries.push_back({ unsigned(i), false, false });
+        }
+
+        // The output size is the number of small Tile16s loaded by the frames (lower is better)
+        results.push_back(runBenchmark(u8"buildSmallTileMap (fast)", args, [&]() {
+            const auto map = MetaSprite::Compiler::buildSmallTileMap(*frameSet, frameEntries, MetaSprite::Compiler::SmallTileMatching::FAST);
+            return countSmallTile16Loads(*frameSet, frameEntries, map);
+        }));
+
+        results.push_back(runBenchmark(u8"buildSmallTileMap (optimised)", args, [&]() {
+            const auto map = MetaSprite::Compiler::buildSmallTileMap(*frameSet, frameEntries, MetaSprite::Compiler::SmallTileMatching::OPTIMISED);
+            return countSmallTile16Loads(*frameSet, frameEntries, map);
+        }));
+
+        // Most frames share a common set of tiles (ie, the body of a character)
+        auto commonTilesFrameSet = std::make_unique<MetaSprite::MetaSprite::FrameSet>(*frameSet);
+        for (auto& frame : commonTilesFrameSet->frames) {
+            if (rng.range(4) != 0) {
+                for (const auto tileId : range(4)) {
+                    MetaSprite::MetaSprite::FrameObject obj;
+                    obj.size = MetaSprite::ObjectSize::SMALL;
+                    obj.tileId = tileId;
+                    frame.objects.push_back(obj);
+                }
+            }
+        }
+
+        // The output size is the number of dynamic Tile16s transferred when every frame is displayed once (lower is better)
+        results.push_back(runBenchmark(u8"layoutTiles", args, [&]() {
+            ErrorList errorList;
+            const auto layout = MetaSprite::Compiler::layoutTiles(*commonTilesFrameSet, frameEntries, errorList);
+
+            size_t sum = layout.staticTiles.size();
+            for (const int tilesetId : layout.frameTilesets) {
+                if (tilesetId >= 0) {
+                    sum += layout.dynamicTiles.at(tilesetId).size();
+                }
+            }
+            return sum;
+        }));
+    }
+
+    {
+        const auto tileData = Snes::snesTileData4bpp(std::vector(tiles.begin(), tiles.begin() + 1536));
+
+        results.push_back(runBenchmark(u8"lz4HcCompress", args, [&]() {
+            return lz4HcCompress(tileData).size();
+        }));
+    }
+
+    {
+        // Simulates the duplicate-heavy frame object/dma data written by the MetaSprite compiler
+        std::vector<std::vector<uint8_t>> pool(512);
+        for (auto& blob : pool) {
+            blob.resize(4 + rng.range(29));
+            for (auto& b : blob) {
+                b = rng.range(256);
+            }
+        }
+
+        std::vector<const std::vector<uint8_t>*> input(2048);
+        for (auto& i : input) {
+            i = &pool.at(rng.range(pool.size()));
+        }
+
+        results.push_back(runBenchmark(u8"RomBinData::addData_Index", args, [&]() {
+            MetaSprite::Compiler::RomBinData romData(u8"Bench");
+
+            size_t sum = 0;
+            for (const auto* blob : input) {
+                sum += romData.addData_Index(*blob);
+            }
+            return sum + romData.data().size();
+        }));
+    }
+
+    {
+        std::vector<std::u8string> roomXml;
+        std::vector<std::u8string> frameSetXml;
+
+        for (const auto& item : project.rooms) {
+            roomXml.push_back(toXml(*item.value, Rooms::writeRoomInput));
+        }
+        for (const auto& fs : project.frameSets) {
+            frameSetXml.push_back(toXml(*fs.msFrameSet, MetaSprite::MetaSprite::writeFrameSet));
+        }
+
+        results.push_back(runBenchmark(u8"XmlReader", args, [&]() {
+            size_t sum = 0;
+            for (const auto& xml : roomXml) {
+                Xml::XmlReader reader{ std::u8string(xml) };
+                sum += Rooms::readRoomInput(reader)->map.cellCount();
+            }
+            for (const auto& xml : frameSetXml) {
+                Xml::XmlReader reader{ std::u8string(xml) };
+                sum += MetaSprite::MetaSprite::readFrameSet(reader)->frames.size();
+            }
+            return sum;
+        }));
+    }
+
+    {
+        const auto data = Snes::snesTileData4bpp(std::vector(tiles.begin(), tiles.begin() + 2048));
+
+        StringStream encoded(128 * 1024);
+        Base64::encode(data, encoded);
+        const std::u8string text(encoded.string_view());
+
+        results.push_back(runBenchmark(u8"Base64::encode", args, [&]() {
+            StringStream out(128 * 1024);
+            Base64::encode(data, out);
+            return out.size();
+        }));
+
+        results.push_back(runBenchmark(u8"Base64::decode", args, [&]() {
+            return Base64::decode(text).size();
+        }));
+    }
+
+    results.push_back(runBenchmark(u8"compileProject", args, [&]() {
+        StringStream errorStream;
+        const auto output = Project::compileProject(project, u8"bench.bin", errorStream);
+        if (!output) {
+            throw runtime_error(u8"Unable to compile synthetic project:\n", errorStream.string_view());
+        }
+        return output->incData.size() + output->binaryData.size();
+    }));
+
+    return results;
+}
+
+static void writeJsonFile(const std::filesystem::path& filename, const Args& args, const std::vector<BenchmarkResult>& results)
+{
+    using namespace std::chrono;
+
+    const auto ns = [](const Clock::duration d) {
+        return int64_t(duration_cast<nanoseconds>(d).count());
+    };
+
+    StringStream out;
+
+    // Keys and benchmarks are always written in the same order
+    out.write(u8"{\n"
+              u8"  \"version\": ",
+              JSON_FORMAT_VERSION, u8",\n",
+              u8"  \"project\": {\n"
+              u8"    \"seed\": ",
+              args.seed, u8",\n",
+              u8"    \"rooms\": ", args.nRooms, u8",\n",
+              u8"    \"frameSets\": ", args.nFrameSets, u8",\n",
+              u8"    \"tilesets\": ", args.nTilesets, u8"\n",
+              u8"  },\n"
+              u8"  \"benchmarks\": [");
+
+    for (const auto [i, r] : const_enumerate(results)) {
+        out.write(i == 0 ? u8"\n" : u8",\n");
+        out.write(u8"    {\n"
+                  u8"      \"name\": \"",
+                  r.name, u8"\",\n",
+                  u8"      \"iterations\": ", r.iterations, u8",\n",
+                  u8"      \"min_ns\": ", ns(r.min), u8",\n",
+                  u8"      \"median_ns\": ", ns(r.median), u8",\n",
+                  u8"      \"mean_ns\": ", ns(r.mean), u8",\n",
+                  u8"      \"output_size\": ", uint64_t(r.outputSize), u8"\n",
+                  u8"    }");
+    }
+
+    out.write(u8"\n  ]\n"
+              u8"}\n");
+
+    File::writeFile(filename, out.string_view());
+}
+
+static int process(const Args& args)
+{
+    const SyntheticProjectSettings settings{
+        .seed = args.seed,
+        .nRooms = args.nRooms,
+        .nFrameSets = args.nFrameSets,
+        .nTilesets = args.nTilesets,
+    };
+
+    const auto project = generateSyntheticProject(settings, args.inputFilename);
+
+    if (args.saveProject) {
+        saveSyntheticProject(*project, args.inputFilename / "synthetic.utproject");
+    }
+
+    const auto results = runBenchmarks(args, *project);
+
+    if (!args.jsonFilename.empty()) {
+        writeJsonFile(args.jsonFilename, args, results);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, const char* argv[])
+{
+    try {
+        const Args args = parseProgramArguments(ARG_PARSER_CONFIG, argc, argv);
+        return process(args);
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "ERROR: " << ex.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}